@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui dbus KWindowSystem dbus x11extras
+QT       += core gui dbus KWindowSystem dbus x11extras concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -35,7 +35,19 @@ SOURCES += src/main.cpp\
     src/aboutdialog.cpp \
     src/configuration.cpp \
     src/servicemanager.cpp \
-    src/xatom-helper.cpp
+    src/xatom-helper.cpp \
+    src/biometricproxy.cpp \
+    src/usernameresolver.cpp \
+    src/deviceregistry.cpp \
+    src/devicetablemodel.cpp \
+    src/devicetabledelegate.cpp \
+    src/devicelistmodel.cpp \
+    src/commandrunner.cpp \
+    src/bioauthstatus.cpp \
+    src/devicesignalrouter.cpp \
+    src/imagecache.cpp \
+    src/frameanimator.cpp \
+    src/dialogpool.cpp
 
 
 HEADERS  += src/mainwindow.h \
@@ -49,7 +61,19 @@ HEADERS  += src/mainwindow.h \
     src/aboutdialog.h \
     src/configuration.h \
     src/servicemanager.h \
-    src/xatom-helper.h
+    src/xatom-helper.h \
+    src/biometricproxy.h \
+    src/usernameresolver.h \
+    src/deviceregistry.h \
+    src/devicetablemodel.h \
+    src/devicetabledelegate.h \
+    src/devicelistmodel.h \
+    src/commandrunner.h \
+    src/bioauthstatus.h \
+    src/devicesignalrouter.h \
+    src/imagecache.h \
+    src/frameanimator.h \
+    src/dialogpool.h
 
 
 FORMS    += src/mainwindow.ui \
@@ -83,4 +107,11 @@ ICON.path = /usr/share/pixmaps/
 desktop.files = data/biometric-manager.desktop
 desktop.path = /usr/share/applications/
 
-INSTALLS += target qm_file ICON desktop
+policy.files = data/org.ukui.biometric-manager.policy
+policy.path = /usr/share/polkit-1/actions/
+
+drivers.files = data/biometric-drivers-apply
+drivers.path = /usr/lib/biometric-manager/
+drivers.CONFIG += executable
+
+INSTALLS += target qm_file ICON desktop policy drivers
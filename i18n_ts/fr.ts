@@ -257,6 +257,39 @@ p, li { white-space: pre-wrap; }
         <translation type="unfinished"></translation>
     </message>
 </context>
+<context>
+    <name>DeviceTableModel</name>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="219"/>
+        <source>Device Name</source>
+        <translation>Nom de l&apos;appareil</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="221"/>
+        <source>Device Status</source>
+        <translation>Statut du périphérique</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="223"/>
+        <source>Driver Status</source>
+        <translation>Statut du conducteur</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="225"/>
+        <source>Default</source>
+        <translation>Défaut</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Connected</source>
+        <translation>Connecté</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Unconnected</source>
+        <translation>Sans rapport</translation>
+    </message>
+</context>
 <context>
     <name>EnumToString</name>
     <message>
@@ -257,6 +257,39 @@ p, li { white-space: pre-wrap; }
         <translation type="unfinished"></translation>
     </message>
 </context>
+<context>
+    <name>DeviceTableModel</name>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="219"/>
+        <source>Device Name</source>
+        <translation>Nome do dispositivo</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="221"/>
+        <source>Device Status</source>
+        <translation>Status do dispositivo</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="223"/>
+        <source>Driver Status</source>
+        <translation>Status do motorista</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="225"/>
+        <source>Default</source>
+        <translation>Padrão</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Connected</source>
+        <translation>Conectado</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Unconnected</source>
+        <translation>Desconectado</translation>
+    </message>
+</context>
 <context>
     <name>EnumToString</name>
     <message>
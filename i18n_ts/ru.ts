@@ -257,6 +257,39 @@ p, li { white-space: pre-wrap; }
         <translation type="unfinished"></translation>
     </message>
 </context>
+<context>
+    <name>DeviceTableModel</name>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="219"/>
+        <source>Device Name</source>
+        <translation>Имя устройства</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="221"/>
+        <source>Device Status</source>
+        <translation>Состояние устройства</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="223"/>
+        <source>Driver Status</source>
+        <translation>Статус драйвера</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="225"/>
+        <source>Default</source>
+        <translation>По умолчанию</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Connected</source>
+        <translation>Связанный</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Unconnected</source>
+        <translation>несвязанный</translation>
+    </message>
+</context>
 <context>
     <name>EnumToString</name>
     <message>
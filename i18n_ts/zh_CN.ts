@@ -563,6 +563,39 @@ p, li { white-space: pre-wrap; }
         <translation type="obsolete">未搜索到</translation>
     </message>
 </context>
+<context>
+    <name>DeviceTableModel</name>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="219"/>
+        <source>Device Name</source>
+        <translation>设备名称</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="221"/>
+        <source>Device Status</source>
+        <translation>设备状态</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="223"/>
+        <source>Driver Status</source>
+        <translation>驱动状态</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="225"/>
+        <source>Default</source>
+        <translation>默认</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Connected</source>
+        <translation>已连接</translation>
+    </message>
+    <message>
+        <location filename="../src/devicetablemodel.cpp" line="159"/>
+        <source>Unconnected</source>
+        <translation>未连接</translation>
+    </message>
+</context>
 <context>
     <name>EnumToString</name>
     <message>
@@ -691,6 +724,18 @@ p, li { white-space: pre-wrap; }
 </context>
 <context>
     <name>MainWindow</name>
+    <message>
+        <source>Discard</source>
+        <translation>放弃</translation>
+    </message>
+    <message>
+        <source>Apply</source>
+        <translation>应用</translation>
+    </message>
+    <message>
+        <source>%1 driver change(s) to apply</source>
+        <translation>%1 项驱动修改待应用</translation>
+    </message>
     <message>
         <location filename="../src/mainwindow.cpp" line="131"/>
         <source>Biometric Manager</source>
@@ -934,6 +979,10 @@ p, li { white-space: pre-wrap; }
         <source>Fail to change device status</source>
         <translation>更改设备状态失败</translation>
     </message>
+    <message>
+        <source>Fail to save the default device to %1: %2</source>
+        <translation>保存默认设备到 %1 失败：%2</translation>
+    </message>
     <message>
         <location filename="../src/mainwindow.cpp" line="251"/>
         <source>Restart Service</source>
@@ -953,7 +1002,7 @@ p, li { white-space: pre-wrap; }
     </message>
     <message>
         <source>Error</source>
-        <translation type="obsolete">错误</translation>
+        <translation>错误</translation>
     </message>
     <message>
         <source>Device is not connected</source>
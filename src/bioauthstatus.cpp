@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#include "bioauthstatus.h"
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QSettings>
+#include <QTimer>
+#include <QDebug>
+
+#define BIOAUTH_RELOAD_DELAY    100     /* 毫秒，合并一次写入产生的多个通知 */
+
+BioAuthStatus *BioAuthStatus::instance_ = nullptr;
+
+BioAuthStatus::BioAuthStatus(QObject *parent)
+    : QObject(parent),
+      watcher(new QFileSystemWatcher(this)),
+      reloadTimer(new QTimer(this)),
+      available(false),
+      enable(false)
+{
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(BIOAUTH_RELOAD_DELAY);
+    connect(reloadTimer, &QTimer::timeout, this, &BioAuthStatus::reload);
+
+    /*
+     * sed -i 之类的修改会用新文件替换旧文件，文件的监视随之失效，
+     * 所以同时监视所在目录，每次重新读取后再补上文件的监视
+     */
+    connect(watcher, &QFileSystemWatcher::fileChanged,
+            reloadTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(watcher, &QFileSystemWatcher::directoryChanged,
+            reloadTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+    enable = readEnable(&available);
+    updateWatcher();
+}
+
+BioAuthStatus *BioAuthStatus::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new BioAuthStatus;
+    }
+    return instance_;
+}
+
+bool BioAuthStatus::isAvailable() const
+{
+    return available;
+}
+
+bool BioAuthStatus::isEnabled() const
+{
+    return enable;
+}
+
+void BioAuthStatus::reload()
+{
+    bool newEnable = readEnable(&available);
+    updateWatcher();
+
+    if(newEnable != enable) {
+        enable = newEnable;
+        qDebug() << "biometric authentication" << (enable ? "enabled" : "disabled");
+        Q_EMIT enableChanged(enable);
+    }
+}
+
+void BioAuthStatus::updateWatcher()
+{
+    QFileInfo fileInfo(BIOAUTH_CONFIG_FILE);
+    QString dir = fileInfo.absolutePath();
+
+    if(QFileInfo::exists(dir) && !watcher->directories().contains(dir))
+        watcher->addPath(dir);
+    if(fileInfo.exists() && !watcher->files().contains(fileInfo.absoluteFilePath()))
+        watcher->addPath(fileInfo.absoluteFilePath());
+}
+
+bool BioAuthStatus::readEnable(bool *available)
+{
+    QFileInfo fileInfo(BIOAUTH_CONFIG_FILE);
+    *available = fileInfo.isFile() && fileInfo.isReadable();
+    if(!*available)
+        return false;
+
+    /* 与 bioctl 一致，只有值为 true 时才算开启 */
+    QSettings settings(BIOAUTH_CONFIG_FILE, QSettings::IniFormat);
+    return settings.value(BIOAUTH_ENABLE_KEY).toString()
+            .compare("true", Qt::CaseInsensitive) == 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#ifndef BIOAUTHSTATUS_H
+#define BIOAUTHSTATUS_H
+
+#include <QObject>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/* bioctl 读写的生物识别总开关配置 */
+#define BIOAUTH_CONFIG_FILE     "/etc/biometric-auth/ukui-biometric.conf"
+#define BIOAUTH_ENABLE_KEY      "EnableAuth"
+
+/**
+ * @brief 生物识别认证开关状态
+ *
+ * 直接读取 bioctl 使用的配置文件，不再启动 bioctl status 子进程；
+ * 监视配置文件，开关在程序外被修改时发出 enableChanged。
+ */
+class BioAuthStatus : public QObject
+{
+    Q_OBJECT
+private:
+    explicit BioAuthStatus(QObject *parent = nullptr);
+    BioAuthStatus(const BioAuthStatus &status) = delete;
+    BioAuthStatus& operator =(const BioAuthStatus &rhs) = delete;
+
+public:
+    static BioAuthStatus *instance();
+    bool isAvailable() const;
+    bool isEnabled() const;
+
+signals:
+    void enableChanged(bool enable);
+
+private:
+    void reload();
+    void updateWatcher();
+    static bool readEnable(bool *available);
+
+private:
+    static BioAuthStatus *instance_;
+    QFileSystemWatcher *watcher;
+    QTimer *reloadTimer;
+    bool available;     //配置文件可以读取
+    bool enable;
+};
+
+#endif // BIOAUTHSTATUS_H
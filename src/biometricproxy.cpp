@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "biometricproxy.h"
+
+BiometricProxy *BiometricProxy::instance_ = nullptr;
+
+BiometricProxy::BiometricProxy(QObject *parent)
+    : QDBusAbstractInterface(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE,
+                             busConnection(), parent)
+{
+    /* 向 QDBus 类型系统注册自定义数据类型 */
+    registerCustomTypes();
+    setTimeout(2147483647); /* 毫秒 */
+}
+
+BiometricProxy *BiometricProxy::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new BiometricProxy;
+    }
+    return instance_;
+}
+
+/**
+ * @brief 生物识别服务所在的总线
+ *
+ * 默认使用系统总线。环境变量 BIOMETRIC_DBUS_BUS 为 session 时使用会话总线，
+ * 为其它非空值时视为总线地址，便于连接 biometric-mock-service 等替身服务。
+ */
+QDBusConnection BiometricProxy::busConnection()
+{
+    static const QString bus = qgetenv("BIOMETRIC_DBUS_BUS");
+
+    if(bus.isEmpty() || bus == "system")
+        return QDBusConnection::systemBus();
+    if(bus == "session")
+        return QDBusConnection::sessionBus();
+    return QDBusConnection::connectToBus(bus, "biometric");
+}
+
+QDBusPendingReply<int, QList<QDBusVariant> > BiometricProxy::GetDrvList()
+{
+    return asyncCall(QStringLiteral("GetDrvList"));
+}
+
+QDBusPendingReply<int, QList<QDBusVariant> > BiometricProxy::GetFeatureList(int drvid, int uid,
+                                                                            int idxStart, int idxEnd)
+{
+    return asyncCall(QStringLiteral("GetFeatureList"), drvid, uid, idxStart, idxEnd);
+}
+
+QDBusPendingReply<int> BiometricProxy::Enroll(int drvid, int uid, int idx, const QString &idxName)
+{
+    return asyncCall(QStringLiteral("Enroll"), drvid, uid, idx, idxName);
+}
+
+QDBusPendingReply<int> BiometricProxy::Verify(int drvid, int uid, int idx)
+{
+    return asyncCall(QStringLiteral("Verify"), drvid, uid, idx);
+}
+
+QDBusPendingReply<int, QList<QDBusVariant> > BiometricProxy::Search(int drvid, int uid,
+                                                                    int idxStart, int idxEnd)
+{
+    return asyncCall(QStringLiteral("Search"), drvid, uid, idxStart, idxEnd);
+}
+
+QDBusPendingReply<int> BiometricProxy::Clean(int drvid, int uid, int idxStart, int idxEnd)
+{
+    return asyncCall(QStringLiteral("Clean"), drvid, uid, idxStart, idxEnd);
+}
+
+QDBusPendingReply<int> BiometricProxy::Rename(int drvid, int uid, int idx, const QString &newName)
+{
+    return asyncCall(QStringLiteral("Rename"), drvid, uid, idx, newName);
+}
+
+QDBusPendingReply<int> BiometricProxy::StopOps(int drvid, int waiting)
+{
+    return asyncCall(QStringLiteral("StopOps"), drvid, waiting);
+}
+
+QDBusPendingReply<int, int, int, int, int, int> BiometricProxy::UpdateStatus(int drvid)
+{
+    return asyncCall(QStringLiteral("UpdateStatus"), drvid);
+}
+
+QDBusPendingReply<QString> BiometricProxy::GetNotifyMesg(int drvid)
+{
+    return asyncCall(QStringLiteral("GetNotifyMesg"), drvid);
+}
+
+QDBusPendingReply<QString> BiometricProxy::GetOpsMesg(int drvid)
+{
+    return asyncCall(QStringLiteral("GetOpsMesg"), drvid);
+}
+
+QDBusPendingReply<int> BiometricProxy::CheckAppApiVersion(int major, int minor, int func)
+{
+    return asyncCall(QStringLiteral("CheckAppApiVersion"), major, minor, func);
+}
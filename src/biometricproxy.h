@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef BIOMETRICPROXY_H
+#define BIOMETRICPROXY_H
+
+#include <QDBusAbstractInterface>
+#include <QDBusPendingReply>
+#include <QDBusPendingCallWatcher>
+#include "customtype.h"
+
+/**
+ * @brief org.ukui.Biometric 的静态代理
+ *
+ * 进程内只有一个实例，方法和信号在编译期确定，
+ * 构造时不会向服务发起 Introspect 调用。
+ */
+class BiometricProxy : public QDBusAbstractInterface
+{
+    Q_OBJECT
+public:
+    static BiometricProxy *instance();
+    static QDBusConnection busConnection();
+
+    QDBusPendingReply<int, QList<QDBusVariant> > GetDrvList();
+    QDBusPendingReply<int, QList<QDBusVariant> > GetFeatureList(int drvid, int uid,
+                                                                int idxStart, int idxEnd);
+    QDBusPendingReply<int> Enroll(int drvid, int uid, int idx, const QString &idxName);
+    QDBusPendingReply<int> Verify(int drvid, int uid, int idx);
+    QDBusPendingReply<int, QList<QDBusVariant> > Search(int drvid, int uid,
+                                                        int idxStart, int idxEnd);
+    QDBusPendingReply<int> Clean(int drvid, int uid, int idxStart, int idxEnd);
+    QDBusPendingReply<int> Rename(int drvid, int uid, int idx, const QString &newName);
+    QDBusPendingReply<int> StopOps(int drvid, int waiting = 5);
+    /* result, enable, dev_num, dev_status, ops_status, notify_mid */
+    QDBusPendingReply<int, int, int, int, int, int> UpdateStatus(int drvid);
+    QDBusPendingReply<QString> GetNotifyMesg(int drvid);
+    QDBusPendingReply<QString> GetOpsMesg(int drvid);
+    QDBusPendingReply<int> CheckAppApiVersion(int major, int minor, int func);
+
+private:
+    explicit BiometricProxy(QObject *parent = nullptr);
+
+signals:
+    void StatusChanged(int drvid, int status);
+    void ProcessChanged(int drvid, const QString &aa, int statusType, const QString &bb);
+    void USBDeviceHotPlug(int drvid, int action, int devNumNow);
+
+private:
+    static BiometricProxy *instance_;
+};
+
+/**
+ * @brief 为异步调用挂接回调
+ *
+ * BiometricProxy 的方法均返回 QDBusPendingReply，调用方不应等待它完成，
+ * 而是通过本函数在应答到达后于 context 所在线程执行 callback。
+ * context 被销毁后回调不再执行。
+ */
+template <typename Reply, typename Func>
+void watchReply(const Reply &reply, QObject *context, Func callback)
+{
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, context);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context,
+                     [watcher, callback]() {
+        Reply result = *watcher;
+        watcher->deleteLater();
+        callback(result);
+    });
+}
+
+#endif // BIOMETRICPROXY_H
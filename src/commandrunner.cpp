@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "commandrunner.h"
+#include <QTimer>
+#include <QDebug>
+
+CommandRunner::CommandRunner(const QString &program, const QStringList &arguments,
+                             QObject *parent)
+    : QObject(parent),
+      program(program),
+      arguments(arguments),
+      process(new QProcess(this)),
+      timer(new QTimer(this)),
+      state_(NotStarted)
+{
+    timer->setSingleShot(true);
+    timer->setInterval(COMMAND_DEFAULT_TIMEOUT);
+
+    connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, &CommandRunner::onFinished);
+    connect(process, &QProcess::errorOccurred, this, &CommandRunner::onErrorOccurred);
+    connect(timer, &QTimer::timeout, this, &CommandRunner::onTimeout);
+}
+
+/**
+ * @brief 随 context 一起销毁时不再发出 finished
+ * 仍在运行的命令不能在这里结束：等待会阻塞界面，而 kill 掉 pkexec 也结束不了它以 root 启动的子进程。
+ * 让进程脱离本对象自行运行，结束后释放。
+ */
+CommandRunner::~CommandRunner()
+{
+    process->disconnect(this);
+    if(process->state() != QProcess::NotRunning) {
+        process->setParent(nullptr);
+        connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                process, &QProcess::deleteLater);
+    }
+}
+
+/**
+ * @brief 启动命令，结束后在 context 所在线程中调用 callback
+ * context 被销毁后 callback 不再调用，命令在后台运行到结束
+ */
+CommandRunner *CommandRunner::run(const QString &program, const QStringList &arguments,
+                                  QObject *context, const Callback &callback, int timeout)
+{
+    CommandRunner *runner = new CommandRunner(program, arguments, context);
+    runner->setTimeout(timeout);
+    connect(runner, &CommandRunner::finished, context, callback);
+    runner->start();
+    return runner;
+}
+
+void CommandRunner::setTimeout(int msec)
+{
+    timer->setInterval(msec);
+}
+
+CommandRunner::State CommandRunner::state() const
+{
+    return state_;
+}
+
+QString CommandRunner::commandLine() const
+{
+    return (QStringList() << program << arguments).join(" ");
+}
+
+void CommandRunner::start()
+{
+    if(state_ != NotStarted)
+        return;
+
+    qDebug() << "run command:" << commandLine();
+    setState(Running);
+    if(timer->interval() > 0)
+        timer->start();
+    process->start(program, arguments);
+}
+
+void CommandRunner::cancel()
+{
+    if(state_ != Running)
+        return;
+
+    result.canceled = true;
+    process->kill();
+}
+
+void CommandRunner::onTimeout()
+{
+    qDebug() << "command timed out:" << commandLine();
+    result.timedOut = true;
+    process->kill();
+}
+
+void CommandRunner::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    result.exitCode = exitCode;
+    result.exitStatus = exitStatus;
+    result.standardOutput = process->readAllStandardOutput();
+    result.standardError = process->readAllStandardError();
+    finish();
+}
+
+void CommandRunner::onErrorOccurred(QProcess::ProcessError error)
+{
+    /* 其它错误之后仍会发出 finished */
+    if(error != QProcess::FailedToStart)
+        return;
+
+    result.failedToStart = true;
+    result.errorString = process->errorString();
+    finish();
+}
+
+void CommandRunner::setState(State state)
+{
+    if(state_ == state)
+        return;
+    state_ = state;
+    Q_EMIT stateChanged(state);
+}
+
+void CommandRunner::finish()
+{
+    if(state_ == Finished)
+        return;
+
+    timer->stop();
+    if(result.errorString.isEmpty() && !result.success())
+        result.errorString = process->errorString();
+    qDebug() << "command finished:" << commandLine() << "exit code:" << result.exitCode
+             << (result.timedOut ? "timed out" : result.canceled ? "canceled" : "");
+
+    setState(Finished);
+    Q_EMIT finished(result);
+    deleteLater();
+}
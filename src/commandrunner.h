@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef COMMANDRUNNER_H
+#define COMMANDRUNNER_H
+
+#include <QObject>
+#include <QProcess>
+#include <functional>
+
+class QTimer;
+
+#define COMMAND_DEFAULT_TIMEOUT     (30 * 1000)
+#define PRIVILEGED_COMMAND_TIMEOUT  (5 * 60 * 1000)     /* 包括等待用户在 polkit 对话框中认证 */
+
+/**
+ * @brief 命令的执行结果
+ */
+struct CommandResult {
+    bool success() const {
+        return !failedToStart && !timedOut && !canceled &&
+                exitStatus == QProcess::NormalExit && exitCode == 0;
+    }
+
+    int exitCode = -1;
+    QProcess::ExitStatus exitStatus = QProcess::NormalExit;
+    bool failedToStart = false;
+    bool timedOut = false;
+    bool canceled = false;
+    QByteArray standardOutput;
+    QByteArray standardError;
+    QString errorString;
+};
+
+/**
+ * @brief 异步执行外部命令（bioctl、pkexec biodrvctl 等）
+ *
+ * 不阻塞界面线程；超时或取消时结束进程。结束后发出 finished 并自行释放。
+ */
+class CommandRunner : public QObject
+{
+    Q_OBJECT
+public:
+    enum State {
+        NotStarted,
+        Running,
+        Finished
+    };
+    Q_ENUM(State)
+
+    typedef std::function<void (const CommandResult &)> Callback;
+
+    explicit CommandRunner(const QString &program, const QStringList &arguments,
+                           QObject *parent = nullptr);
+    ~CommandRunner();
+
+    static CommandRunner *run(const QString &program, const QStringList &arguments,
+                              QObject *context, const Callback &callback,
+                              int timeout = COMMAND_DEFAULT_TIMEOUT);
+
+    void setTimeout(int msec);
+    void start();
+    void cancel();
+    State state() const;
+    QString commandLine() const;
+
+signals:
+    void stateChanged(CommandRunner::State state);
+    void finished(const CommandResult &result);
+
+private:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onTimeout();
+    void setState(State state);
+    void finish();
+
+private:
+    QString program;
+    QStringList arguments;
+    QProcess *process;
+    QTimer *timer;
+    State state_;
+    CommandResult result;
+};
+
+#endif // COMMANDRUNNER_H
@@ -18,45 +18,229 @@
 
 #include "configuration.h"
 #include <QSettings>
+#include <QCoreApplication>
+#include <QtConcurrent>
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QTimer>
 #include <QDir>
 #include <QDebug>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define CONFIG_RELOAD_DELAY 100     /* 毫秒，合并一次写入产生的多个通知 */
+#define CONFIG_SAVE_DELAY   300     /* 毫秒，合并连续的修改 */
 
 QString Configuration::configFile = QDir::homePath() +
         "/.biometric_auth/ukui_biometric.conf";
 
-Configuration* Configuration::instance_ = new Configuration;
+Configuration* Configuration::instance_ = nullptr;
 
-Configuration::Configuration(QObject *parent) : QObject(parent)
+Configuration::Configuration(QObject *parent)
+    : QObject(parent),
+      watcher(new QFileSystemWatcher(this)),
+      reloadTimer(new QTimer(this)),
+      saveTimer(new QTimer(this)),
+      saveWatcher(new QFutureWatcher<SaveErrors>(this)),
+      savePending(false)
 { 
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(CONFIG_RELOAD_DELAY);
+    connect(reloadTimer, &QTimer::timeout, this, &Configuration::reload);
+
+    /* greeter 或其它会话修改配置文件时重新读取；QSettings 写入时会替换文件，所以同时监视目录 */
+    connect(watcher, &QFileSystemWatcher::fileChanged,
+            reloadTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(watcher, &QFileSystemWatcher::directoryChanged,
+            reloadTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(CONFIG_SAVE_DELAY);
+    connect(saveTimer, &QTimer::timeout, this, &Configuration::startSave);
+    connect(saveWatcher, &QFutureWatcher<SaveErrors>::finished,
+            this, &Configuration::onSaveFinished);
+    /* 退出前写入还没有保存的修改 */
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &Configuration::flush);
 
+    defaultDevice = readDefaultDevice();
+    updateWatcher();
 }
 
 Configuration *Configuration::instance()
 {
+    if(!instance_)
+    {
+        instance_ = new Configuration;
+    }
     return instance_;
 }
 
+/**
+ * @brief 获取默认设备，只读取内存中的缓存
+ */
 QString Configuration::getDefaultDevice()
+{
+    return defaultDevice;
+}
+
+QString Configuration::readDefaultDevice() const
 {
     QSettings settings(configFile, QSettings::IniFormat);
 
     return settings.value("DefaultDevice").toString();
 }
 
+void Configuration::reload()
+{
+    /* 本进程的修改还没有写完时以缓存为准 */
+    if(savePending || saveWatcher->isRunning())
+        return;
+
+    QString deviceName = readDefaultDevice();
+    updateWatcher();
+
+    if(deviceName != defaultDevice) {
+        qDebug() << "default device changed outside:" << deviceName;
+        defaultDevice = deviceName;
+        emit defaultDeviceChanged(deviceName);
+    }
+}
+
+void Configuration::updateWatcher()
+{
+    /* 配置目录还不存在时先监视家目录，等目录创建后再切换过去 */
+    QFileInfo fileInfo(configFile);
+    QString dir = QFileInfo::exists(fileInfo.absolutePath()) ?
+                fileInfo.absolutePath() : QDir::homePath();
+
+    if(!watcher->directories().contains(dir)) {
+        if(!watcher->directories().isEmpty())
+            watcher->removePaths(watcher->directories());
+        watcher->addPath(dir);
+    }
+    if(fileInfo.exists() && !watcher->files().contains(fileInfo.absoluteFilePath()))
+        watcher->addPath(fileInfo.absoluteFilePath());
+}
+
+/**
+ * @brief 设置默认设备
+ * 立即更新缓存并通知，文件在短暂延迟后由工作线程写入，连续的修改只写最后一次
+ */
 void Configuration::setDefaultDevice(const QString &deviceName)
 {
     qDebug() << deviceName;
-    QSettings settings(configFile, QSettings::IniFormat);
+    if(deviceName == defaultDevice && !savePending)
+        return;
 
-    settings.setValue("DefaultDevice", deviceName);
-    settings.sync();
+    defaultDevice = deviceName;
+    savePending = true;
+    saveTimer->start();
+
+    emit defaultDeviceChanged(deviceName);
+}
+
+/**
+ * @brief 同步写入还没有保存的修改
+ */
+void Configuration::flush()
+{
+    saveTimer->stop();
+    saveWatcher->waitForFinished();
+    if(!savePending)
+        return;
+
+    savePending = false;
+    SaveErrors errors = saveDefaultDevice({configFile}, defaultDevice);
+    for(auto iter = errors.constBegin(); iter != errors.constEnd(); ++iter)
+        qDebug() << "save" << iter.key() << "failed:" << iter.value();
+}
+
+void Configuration::startSave()
+{
+    /* 上一次写入完成后再写入最新的值 */
+    if(saveWatcher->isRunning() || !savePending)
+        return;
+
+    savePending = false;
+    saveWatcher->setFuture(QtConcurrent::run(&Configuration::saveDefaultDevice,
+                                             QStringList{configFile}, defaultDevice));
+}
+
+void Configuration::onSaveFinished()
+{
+    SaveErrors errors = saveWatcher->result();
+    for(auto iter = errors.constBegin(); iter != errors.constEnd(); ++iter) {
+        qDebug() << "save" << iter.key() << "failed:" << iter.value();
+        emit saveFailed(iter.key(), iter.value());
+    }
+
+    if(savePending)
+        startSave();
+}
+
+/**
+ * @brief 在工作线程中写入家目录的配置文件和 greeter 使用的配置文件
+ */
+Configuration::SaveErrors Configuration::saveDefaultDevice(const QStringList &files,
+                                                           const QString &deviceName)
+{
+    SaveErrors errors;
+    QString errorString;
+
+    for(const QString &fileName : files)
+        if(!writeConfigFile(fileName, deviceName, &errorString))
+            errors.insert(fileName, errorString);
 
     //由于greeter没有权限访问家目录，所以单独写一个配置文件
-    QString configFile1 = QString("/var/lib/lightdm-data/%1/.biometric_auth/ukui_biometric.conf").arg(getenv("USER"));
-    QSettings settings1(configFile1, QSettings::IniFormat);
+    //不是 lightdm 的系统上没有这个目录，直接跳过
+    QString greeterDir = QString("/var/lib/lightdm-data/%1").arg(getenv("USER"));
+    QString configFile1 = greeterDir + "/.biometric_auth/ukui_biometric.conf";
+    if(QFileInfo(greeterDir).isDir() &&
+            !writeConfigFile(configFile1, deviceName, &errorString))
+        errors.insert(configFile1, errorString);
 
-    settings1.setValue("DefaultDevice", deviceName);
-    settings1.sync();
+    return errors;
+}
 
-    emit defaultDeviceChanged(deviceName);
+/**
+ * @brief 原子地修改配置文件
+ * 先在同一目录下的临时文件中修改，再用 rename 替换，读取方不会看到写了一半的文件
+ */
+bool Configuration::writeConfigFile(const QString &fileName, const QString &deviceName,
+                                    QString *errorString)
+{
+    QFileInfo fileInfo(fileName);
+    QString tempFile = fileName + ".new";
+
+    if(!QDir().mkpath(fileInfo.absolutePath())) {
+        *errorString = QString("cannot create directory %1").arg(fileInfo.absolutePath());
+        return false;
+    }
+
+    /* 保留文件中的其它配置项 */
+    QFile::remove(tempFile);
+    if(fileInfo.exists() && !QFile::copy(fileName, tempFile)) {
+        *errorString = QString("cannot create %1").arg(tempFile);
+        return false;
+    }
+
+    {
+        QSettings settings(tempFile, QSettings::IniFormat);
+        settings.setValue("DefaultDevice", deviceName);
+        settings.sync();
+        if(settings.status() != QSettings::NoError) {
+            *errorString = QString("cannot write %1").arg(tempFile);
+            QFile::remove(tempFile);
+            return false;
+        }
+    }
+
+    if(::rename(QFile::encodeName(tempFile).constData(),
+                QFile::encodeName(fileName).constData()) != 0) {
+        *errorString = QString::fromLocal8Bit(strerror(errno));
+        QFile::remove(tempFile);
+        return false;
+    }
+    return true;
 }
@@ -20,6 +20,11 @@
 #define CONFIGURATION_H
 
 #include <QObject>
+#include <QHash>
+#include <QFutureWatcher>
+
+class QFileSystemWatcher;
+class QTimer;
 
 class Configuration : public QObject
 {
@@ -30,16 +35,36 @@ private:
     Configuration& operator =(const Configuration &rhs) = delete;
 
 public:
+    typedef QHash<QString, QString> SaveErrors;    //文件名 -> 错误信息
+
     static Configuration *instance();
     QString getDefaultDevice();
     void setDefaultDevice(const QString &deviceName);
+    void flush();
+
+private:
+    void reload();
+    void updateWatcher();
+    QString readDefaultDevice() const;
+    void startSave();
+    void onSaveFinished();
+    static SaveErrors saveDefaultDevice(const QStringList &files, const QString &deviceName);
+    static bool writeConfigFile(const QString &fileName, const QString &deviceName,
+                                QString *errorString);
 
 private:
     static QString configFile;
     static Configuration *instance_;
+    QFileSystemWatcher *watcher;
+    QTimer *reloadTimer;
+    QString defaultDevice;      //配置文件内容的缓存，由 watcher 更新
+    QTimer *saveTimer;
+    QFutureWatcher<SaveErrors> *saveWatcher;
+    bool savePending;           //缓存中有还没有写入文件的修改
 
 signals:
     void defaultDeviceChanged(const QString &deviceName);
+    void saveFailed(const QString &fileName, const QString &errorString);
 };
 
 #endif // CONFIGURATION_H
@@ -21,36 +21,42 @@
 #include "promptdialog.h"
 #include "inputdialog.h"
 #include "messagedialog.h"
+#include "dialogpool.h"
 #include "configuration.h"
+#include "biometricproxy.h"
 #include <QPoint>
 #include <QHoverEvent>
 #include <QEvent>
+#include <QShowEvent>
 
 #define ICON_SIZE 32
 
 
-ContentPane::ContentPane(int uid, DeviceInfo *deviceInfo, QWidget *parent) :
+ContentPane::ContentPane(int uid, const DeviceInfo &deviceInfo, QWidget *parent) :
 	QWidget(parent),
     ui(new Ui::ContentPane),
     deviceInfo(deviceInfo),
     currentUid(uid),
-    dataModel(nullptr)
+    dataModel(nullptr),
+    hasDeleteSuccess(false),
+    featuresRequested(false),
+    fetchGeneration(0)
 {
     ui->setupUi(this);
-	/* 向 QDBus 类型系统注册自定义数据类型 */
-	registerCustomTypes();
 	/* 连接 DBus Daemon */
-    serviceInterface = new QDBusInterface(DBUS_SERVICE,
-                                          DBUS_PATH,
-                                          DBUS_INTERFACE
-                                          , QDBusConnection::systemBus());
-    serviceInterface->setTimeout(2147483647); /* 微秒 */
+    serviceInterface = BiometricProxy::instance();
 	updateWidgetStatus();
 	/* 设置数据模型 */
 	setModel();
 	showDeviceInfo();
-    showFeatures();
 
+    connect(Configuration::instance(), &Configuration::defaultDeviceChanged,
+            this, [this](const QString &deviceName) {
+        if(deviceName == this->deviceInfo.device_shortname)
+            ui->cbDefault->setChecked(true);
+        else
+            ui->cbDefault->setChecked(false);
+    });
 }
 
 ContentPane::~ContentPane()
@@ -64,28 +70,46 @@ ContentPane::~ContentPane()
 void ContentPane::setModel()
 {
 	/* 设置 TreeView 的 Model */
-    dataModel = new TreeModel(currentUid, BioType(deviceInfo->biotype), this);
+    dataModel = new TreeModel(currentUid, BioType(deviceInfo.biotype), this);
+    connect(dataModel, &TreeModel::fetchRequested, this, &ContentPane::fetchFeatures);
     ui->treeView->setModel(dataModel);
 	ui->treeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->treeView->setFocusPolicy(Qt::NoFocus);
 }
 
-void ContentPane::setDeviceInfo(DeviceInfo *deviceInfo)
+/**
+ * @brief 设备信息有变化时原地更新，已加载的特征列表保留
+ */
+void ContentPane::setDeviceInfo(const DeviceInfo &deviceInfo)
 {
+    bool availableChanged = (deviceInfo.device_available > 0) !=
+            (this->deviceInfo.device_available > 0);
     this->deviceInfo = deviceInfo;
-    updateWidgetStatus();
+    showDeviceInfo();
+    if(availableChanged)
+        setDeviceAvailable(deviceInfo.device_available);
+    else
+        updateWidgetStatus();
 }
 
 void ContentPane::setDeviceAvailable(int deviceAvailable)
 {
+    deviceInfo.device_available = deviceAvailable;
     if(deviceAvailable) {
         ui->lblDevStatus->setText(tr("Connected"));
-        showFeatures();
+        /* 还没显示过的页面留到第一次显示时再查询 */
+        if(featuresRequested)
+            refreshFeatures();
+        else if(isVisible())
+            showFeatures();
     } else {
+        /* 保留列表（视图已禁用），重新连接后只更新变化的部分 */
         ui->lblDevStatus->setText(tr("Unconnected"));
-        dataModel->removeAll();
+        fetchGeneration++;
+        allLoadedCallbacks.clear();
+        dataModel->cancelFetch();
+        setCursor(Qt::ArrowCursor);
     }
-    deviceInfo->device_available = deviceAvailable;
     updateWidgetStatus();
     qDebug() << "status changed:" << ui->lblDevStatus->text();
 }
@@ -99,21 +123,21 @@ int ContentPane::featuresCount()
 
 void ContentPane::updateWidgetStatus()
 {
-    if (deviceInfo->driver_enable > 0) {
+    if (deviceInfo.driver_enable > 0) {
         ui->btnStatus->setStyleSheet("QPushButton{background:url(:/images/assets/switch_open_small.png);}");
         ui->labelStatusText->setText(tr("Opened"));
     } else {
         ui->btnStatus->setStyleSheet("QPushButton{background:url(:/images/assets/switch_close_small.png);}");
         ui->labelStatusText->setText(tr("Closed"));
     }
-    ui->btnEnroll->setEnabled(deviceInfo->device_available > 0);
-    ui->btnDelete->setEnabled(deviceInfo->device_available > 0);
-    ui->btnVerify->setEnabled(deviceInfo->device_available > 0);
-    ui->btnSearch->setEnabled(deviceInfo->device_available > 0);
-    ui->btnClean->setEnabled(deviceInfo->device_available > 0);
-    ui->treeView->setEnabled(deviceInfo->device_available > 0);
-
-    if(deviceInfo->device_shortname == "huawei"){
+    ui->btnEnroll->setEnabled(deviceInfo.device_available > 0);
+    ui->btnDelete->setEnabled(deviceInfo.device_available > 0);
+    ui->btnVerify->setEnabled(deviceInfo.device_available > 0);
+    ui->btnSearch->setEnabled(deviceInfo.device_available > 0);
+    ui->btnClean->setEnabled(deviceInfo.device_available > 0);
+    ui->treeView->setEnabled(deviceInfo.device_available > 0);
+
+    if(deviceInfo.device_shortname == "huawei"){
         ui->btnVerify->setEnabled(false);
         ui->btnSearch->setEnabled(false);
     }
@@ -127,7 +151,7 @@ void ContentPane::updateButtonUsefulness()
 	ui->btnSearch->setEnabled(enable);
     ui->btnClean->setEnabled(enable);
 
-    if(deviceInfo->device_shortname == "huawei"){
+    if(deviceInfo.device_shortname == "huawei"){
         ui->btnVerify->setEnabled(false);
         ui->btnSearch->setEnabled(false);
     }
@@ -140,21 +164,21 @@ void ContentPane::updateButtonUsefulness()
  */
 bool ContentPane::deviceIsAvailable()
 {
-    return deviceInfo->device_available > 0;
+    return deviceInfo.device_available > 0;
 }
 
 
 void ContentPane::showDeviceInfo()
 {
-    QString verifyType = EnumToString::transferVerifyType(deviceInfo->vertype);
-    QString busType = EnumToString::transferBusType(deviceInfo->bustype);
-    QString storageType = EnumToString::transferStorageType(deviceInfo->stotype);
-    QString identifyType = EnumToString::transferIdentifyType(deviceInfo->idtype);
-    QString listName = EnumToString::transferBioType(deviceInfo->biotype) + tr("List");
-    QString devStatus = deviceInfo->device_available > 0 ? tr("Connected") : tr("Unconnected");
-
-    ui->labelDeviceShortName->setText(deviceInfo->device_shortname);
-    ui->labelDeviceFullName->setText(deviceInfo->device_fullname);
+    QString verifyType = EnumToString::transferVerifyType(deviceInfo.vertype);
+    QString busType = EnumToString::transferBusType(deviceInfo.bustype);
+    QString storageType = EnumToString::transferStorageType(deviceInfo.stotype);
+    QString identifyType = EnumToString::transferIdentifyType(deviceInfo.idtype);
+    QString listName = EnumToString::transferBioType(deviceInfo.biotype) + tr("List");
+    QString devStatus = deviceInfo.device_available > 0 ? tr("Connected") : tr("Unconnected");
+
+    ui->labelDeviceShortName->setText(deviceInfo.device_shortname);
+    ui->labelDeviceFullName->setText(deviceInfo.device_fullname);
     ui->labelVerifyType->setText(verifyType);
     ui->labelBusType->setText(busType);
     ui->labelStorageType->setText(storageType);
@@ -162,82 +186,169 @@ void ContentPane::showDeviceInfo()
     ui->labelListName->setText(listName);
     ui->lblDevStatus->setText(devStatus);
 
-    if(Configuration::instance()->getDefaultDevice() == deviceInfo->device_shortname)
-        ui->cbDefault->setChecked(true);
-
-    connect(Configuration::instance(), &Configuration::defaultDeviceChanged,
-            this, [&](const QString &deviceName) {
-        if(deviceName == deviceInfo->device_shortname)
-            ui->cbDefault->setChecked(true);
-        else
-            ui->cbDefault->setChecked(false);
-    });
+    ui->cbDefault->setChecked(Configuration::instance()->getDefaultDevice() ==
+                              deviceInfo.device_shortname);
 }
 
 void ContentPane::on_btnStatus_clicked()
 {
-    Q_EMIT changeDeviceStatus(deviceInfo);
+    Q_EMIT changeDeviceStatus(&deviceInfo);
 }
 
 void ContentPane::on_cbDefault_clicked(bool checked)
 {
     if(checked)
-        Configuration::instance()->setDefaultDevice(deviceInfo->device_shortname);
+        Configuration::instance()->setDefaultDevice(deviceInfo.device_shortname);
     else
         Configuration::instance()->setDefaultDevice("");
 }
 
 
 
+void ContentPane::showEvent(QShowEvent *event)
+{
+    if(!featuresRequested)
+        showFeatures();
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief 空闲时预取特征列表
+ * @return 是否发出了查询，没有发出时不会有 featuresLoaded 信号
+ */
+bool ContentPane::prefetchFeatures()
+{
+    if(featuresRequested || !deviceIsAvailable())
+        return false;
+    showFeatures();
+    return true;
+}
+
 /**
  * @brief 显示生物识别数据列表
  * @param biotype
  */
 void ContentPane::showFeatures()
 {
+    featuresRequested = true;
+    fetchGeneration++;
     dataModel->removeAll();
 
-	if (!deviceIsAvailable())
+	if (!deviceIsAvailable()) {
+        allLoadedCallbacks.clear();
 		return;
+    }
 	
 	setCursor(Qt::WaitCursor);
 	//QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-	QList<QVariant> args;
+    /* 先取第一页，其余的随视图滚动由 TreeModel::fetchMore 请求 */
+    dataModel->resetFetch();
+    dataModel->fetchMore(QModelIndex());
+}
+
+/**
+ * @brief 重新获取已加载范围内的特征，和当前列表比较后只更新变化的部分
+ */
+void ContentPane::refreshFeatures()
+{
+    if(!deviceIsAvailable() || dataModel->isFetching() || dataModel->rowCount() == 0) {
+        showFeatures();
+        return;
+    }
+
+    int generation = ++fetchGeneration;
+    watchReply(serviceInterface->GetFeatureList(deviceInfo.device_id,
+                                                isAdmin(currentUid) ? -1 : currentUid,
+                                                0, dataModel->loadedIndexEnd()),
+               this, [this, generation](const FeatureListReply &reply) {
+        if(generation != fetchGeneration)
+            return;
+        if(reply.isError()) {
+            errorCallback(reply.error());
+            return;
+        }
+
+        int listsize = reply.argumentAt<0>();
+        if(listsize < 0) {
+            qWarning() << "GetFeatureList failed:" << listsize;
+            return;
+        }
+        dataModel->syncFeatures(decodeVariantArray<FeatureInfo>(reply.reply(), 1, listsize));
+        updateButtonUsefulness();
+    });
+}
 
-	args << QVariant(deviceInfo->device_id)
-        << QVariant((isAdmin(currentUid) ? -1 : currentUid)) << QVariant(0) << QVariant(-1);
-    serviceInterface->callWithCallback("GetFeatureList", args, this,
-                        SLOT(showFeaturesCallback(QDBusMessage)),
-						SLOT(errorCallback(QDBusError)));
+/**
+ * @brief 查询索引在 [idxStart, idxEnd] 内的特征，idxEnd 为 -1 表示到末尾
+ */
+void ContentPane::fetchFeatures(int idxStart, int idxEnd)
+{
+    int generation = fetchGeneration;
+    watchReply(serviceInterface->GetFeatureList(deviceInfo.device_id,
+                                                isAdmin(currentUid) ? -1 : currentUid,
+                                                idxStart, idxEnd),
+               this, [this, generation](const FeatureListReply &reply) {
+        if(generation != fetchGeneration)
+            return;
+        showFeaturesCallback(reply);
+    });
 }
 
 /**
  * @brief 特征列表返回后回调函数进行显示
  * @param callbackReply
  */
-void ContentPane::showFeaturesCallback(QDBusMessage callbackReply)
-{
-    QList<QDBusVariant> qlist;
-    FeatureInfo *featureInfo;
-	int listsize;
-
-	QList<QVariant> variantList = callbackReply.arguments();
-	listsize = variantList[0].value<int>();
-	variantList[1].value<QDBusArgument>() >> qlist;
-	for (int i = 0; i < listsize; i++) {
-        featureInfo = new FeatureInfo;
-        qlist[i].variant().value<QDBusArgument>() >> *featureInfo;
-        dataModel->appendData(featureInfo);
-	}
-	
-	setCursor(Qt::ArrowCursor);
+void ContentPane::showFeaturesCallback(const FeatureListReply &reply)
+{
+    if(reply.isError()) {
+        errorCallback(reply.error());
+        dataModel->finishFetch(-1);
+    } else {
+        int listsize = reply.argumentAt<0>();
+        QVector<FeatureInfo> featureList =
+                decodeVariantArray<FeatureInfo>(reply.reply(), 1, listsize);
+
+        /* 整页一次性加入模型 */
+        dataModel->appendFeatures(featureList);
+        dataModel->finishFetch(listsize);
+
+        /* 空页不会触发视图继续加载；有等待完整列表的操作时也直接取完 */
+        if(dataModel->canFetchMore(QModelIndex()) &&
+                (listsize == 0 || !allLoadedCallbacks.isEmpty()))
+            dataModel->fetchMore(QModelIndex());
+    }
 
-	updateButtonUsefulness();
+    if(!dataModel->isFetching()) {
+        setCursor(Qt::ArrowCursor);
+        updateButtonUsefulness();
+    }
+    if(!dataModel->isFetching() && !dataModel->canFetchMore(QModelIndex())) {
+        QList<std::function<void ()>> callbacks = allLoadedCallbacks;
+        allLoadedCallbacks.clear();
+        for(auto callback : callbacks)
+            callback();
+    }
+    Q_EMIT featuresLoaded();
+}
+
+/**
+ * @brief 确保特征列表已完整加载后执行 callback
+ * 空闲索引和重名检查都需要完整的列表
+ */
+void ContentPane::loadAllFeatures(const std::function<void ()> &callback)
+{
+    if(!dataModel->isFetching() && !dataModel->canFetchMore(QModelIndex())) {
+        callback();
+        return;
+    }
+    allLoadedCallbacks.append(callback);
+    setCursor(Qt::WaitCursor);
+    dataModel->fetchRemaining();
 }
 
 QString ContentPane::inputFeatureName(bool isNew)
 {
-    InputDialog *inputDialog = new InputDialog(this);
+    PooledDialog<InputDialog> inputDialog(DialogPool::instance()->acquireInputDialog());
     if(isNew) {
         inputDialog->setTitle(tr("New Feature"));
         inputDialog->setPrompt(tr("Please input a name for the feature:"));
@@ -245,7 +356,7 @@ QString ContentPane::inputFeatureName(bool isNew)
         inputDialog->setTitle(tr("Rename Feature"));
         inputDialog->setPrompt(tr("Please input a new name for the feature:"));
     }
-    connect(inputDialog, &InputDialog::dataChanged, this, [&](const QString &text){
+    connect(inputDialog.data(), &InputDialog::dataChanged, this, [&](const QString &text){
         if(dataModel->hasFeature(currentUid, text)) {
             inputDialog->setError(tr("Duplicate feature name"));
         } else if(text.isEmpty()) {
@@ -262,8 +373,6 @@ QString ContentPane::inputFeatureName(bool isNew)
     if(inputDialog->exec() != QDialog::Rejected)
         featureName = inputDialog->getText();
 
-    delete inputDialog;
-
     return featureName;
 }
 
@@ -271,6 +380,11 @@ QString ContentPane::inputFeatureName(bool isNew)
  * @brief 录入
  */
 void ContentPane::on_btnEnroll_clicked()
+{
+    loadAllFeatures([this]{ enrollFeature(); });
+}
+
+void ContentPane::enrollFeature()
 {
     indexName = inputFeatureName(true);
     if(indexName.isEmpty())
@@ -280,17 +394,18 @@ void ContentPane::on_btnEnroll_clicked()
     freeIndex = dataModel->freeIndex();
     qDebug() << "Enroll: uid--" << currentUid << " index--" << freeIndex
              << " indexName--" << indexName;
-    promptDialog = new PromptDialog(serviceInterface, deviceInfo->biotype,
-                                    deviceInfo->device_id, currentUid, this);
-    if(deviceInfo->device_shortname == "huawei")
+    promptDialog = DialogPool::instance()->acquirePromptDialog(deviceInfo.biotype,
+                                                               deviceInfo.device_id, currentUid);
+    if(deviceInfo.device_shortname == "huawei")
         promptDialog->setProcessed(true);
-    promptDialog->enroll(deviceInfo->device_id, currentUid, freeIndex, indexName);
+    promptDialog->enroll(deviceInfo.device_id, currentUid, freeIndex, indexName);
     qDebug() << "Enroll result: ----- " << promptDialog->getResult();
     if(promptDialog->getResult() == PromptDialog::SUCESS) {
         FeatureInfo *featureInfo = createNewFeatureInfo();
         dataModel->insertData(featureInfo);
     }
-    delete promptDialog;
+    DialogPool::instance()->release(promptDialog);
+    promptDialog = nullptr;
 
 
     updateButtonUsefulness();
@@ -300,8 +415,8 @@ FeatureInfo *ContentPane::createNewFeatureInfo()
 {
     FeatureInfo *featureInfo = new FeatureInfo;
     featureInfo->uid = currentUid;
-    featureInfo->biotype = deviceInfo->biotype;
-    featureInfo->device_shortname = deviceInfo->device_shortname;
+    featureInfo->biotype = deviceInfo.biotype;
+    featureInfo->device_shortname = deviceInfo.device_shortname;
     featureInfo->index = freeIndex;
     featureInfo->index_name = indexName;
     return featureInfo;
@@ -328,11 +443,11 @@ bool ContentPane::confirmDelete(bool all)
         text = tr("Confirm whether delete the features selected?");
         title = tr("Confirm Delete");
     }
-    MessageDialog dialog(MessageDialog::Question,"","",this);
-    dialog.setTitle(title);
-    dialog.setWindowTitle(title);
-    dialog.setMessage(text);
-    return dialog.exec() == QDialog::Accepted;
+    PooledDialog<MessageDialog> dialog(DialogPool::instance()->acquireMessageDialog(MessageDialog::Question));
+    dialog->setTitle(title);
+    dialog->setWindowTitle(title);
+    dialog->setMessage(text);
+    return dialog->exec() == QDialog::Accepted;
 }
 
 
@@ -343,11 +458,11 @@ void ContentPane::on_btnDelete_clicked()
 {
     QModelIndexList selectedIndexList = ui->treeView->selectionModel()->selectedRows(0);
     if(selectedIndexList.size() <= 0){
-        MessageDialog msgDialog(MessageDialog::Normal,"","",this);
-        msgDialog.setTitle(tr("Feature Delete"));
-        msgDialog.setWindowTitle(tr("Feature Delete"));
-        msgDialog.setMessage(tr("Please select the feature you want to delete."));
-        msgDialog.exec();
+        PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(MessageDialog::Normal));
+        msgDialog->setTitle(tr("Feature Delete"));
+        msgDialog->setWindowTitle(tr("Feature Delete"));
+        msgDialog->setMessage(tr("Please select the feature you want to delete."));
+        msgDialog->exec();
 
         return;
     }
@@ -360,54 +475,81 @@ void ContentPane::on_btnDelete_clicked()
     std::sort(selectedIndexList.begin(), bound, cmp);
     std::sort(bound, selectedIndexList.end(), cmp);
 
-    QStringList resultStrings;
-    bool hasDeleteSuccess = false;
+    deleteTasks.clear();
+    deleteResults.clear();
+    hasDeleteSuccess = false;
 
     for(auto index : selectedIndexList) {
-        int idxStart, idxEnd;
-        int uid = index.data(TreeModel::UidRole).toInt();
+        DeleteTask task;
+        task.uid = index.data(TreeModel::UidRole).toInt();
         bool recursive = !ui->treeView->isExpanded(index) &&
                 (index.child(0, 0) != QModelIndex());
         if(recursive) {
             //如果没有展开则删除该用户的所有特征
-            idxStart = 0;
-            idxEnd = -1;
+            task.idxStart = 0;
+            task.idxEnd = -1;
         } else {
-            idxStart = idxEnd = index.data(Qt::UserRole).toInt();
+            task.idxStart = task.idxEnd = index.data(Qt::UserRole).toInt();
         }
-        qDebug() << "Delete: uid--" << uid << " index--" << idxStart << idxEnd;
+        task.featureName = index.data(TreeModel::NameRole).toString();
+        deleteTasks.append(task);
+    }
+
+    setCursor(Qt::WaitCursor);
+    ui->btnDelete->setEnabled(false);
+    ui->btnClean->setEnabled(false);
+    deleteNextFeature();
+}
+
+/**
+ * @brief 依次删除选中的特征
+ * 设备同一时刻只能处理一个操作，所以上一个 Clean 返回后才发起下一个
+ */
+void ContentPane::deleteNextFeature()
+{
+    if(deleteTasks.isEmpty()) {
+        setCursor(Qt::ArrowCursor);
+        if(hasDeleteSuccess)
+            refreshFeatures();
+        updateButtonUsefulness();
+
+        PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(MessageDialog::Normal));
+        msgDialog->setTitle(tr("Delete"));
+        msgDialog->setWindowTitle(tr("Delete"));
+        msgDialog->setMessage("             " + tr("The result of delete:"));
+        msgDialog->setMessageList(deleteResults);
+        msgDialog->exec();
+        return;
+    }
+
+    DeleteTask task = deleteTasks.takeFirst();
+    qDebug() << "Delete: uid--" << task.uid << " index--" << task.idxStart << task.idxEnd;
 
-        QDBusPendingReply<int> reply = serviceInterface->call("Clean",
-                deviceInfo->device_id, uid, idxStart, idxEnd);
-        reply.waitForFinished();
+    watchReply(serviceInterface->Clean(deviceInfo.device_id, task.uid,
+                                       task.idxStart, task.idxEnd),
+               this, [this, task](const QDBusPendingReply<int> &reply) {
         if (reply.isError()) {
             qWarning() << "DBUS:" << reply.error();
+            /* 服务出错后剩下的任务也无法完成，记录错误后直接显示结果 */
+            deleteResults.append("                " + task.featureName + ":    " + tr("DBus calling error"));
+            deleteTasks.clear();
+            deleteNextFeature();
             return;
         }
 
-        int result = reply.argumentAt(0).value<int>();
-        QString featureName = index.data(TreeModel::NameRole).toString();
-        QString resultString;
-        if(result != DBUS_RESULT_SUCCESS)
-            resultString = featureName + ":    " + getErrorMessage(DELETE, result);
-        else {
-            resultString = featureName + ":    " + tr("Delete successfully");
-            hasDeleteSuccess = true;
+        int result = reply.value();
+        if(result != DBUS_RESULT_SUCCESS) {
+            getErrorMessage(DELETE, result, [this, task](const QString &errorMessage) {
+                deleteResults.append("                " + task.featureName + ":    " + errorMessage);
+                deleteNextFeature();
+            });
+            return;
         }
 
-        resultStrings.append("                " + resultString);
-    }
-    if(hasDeleteSuccess) {
-        showFeatures();
-        updateButtonUsefulness();
-    }
-
-    MessageDialog msgDialog(MessageDialog::Normal,"","",this);
-    msgDialog.setTitle(tr("Delete"));
-    msgDialog.setWindowTitle(tr("Delete"));
-    msgDialog.setMessage("             " + tr("The result of delete:"));
-    msgDialog.setMessageList(resultStrings);
-    msgDialog.exec();
+        hasDeleteSuccess = true;
+        deleteResults.append("                " + task.featureName + ":    " + tr("Delete successfully"));
+        deleteNextFeature();
+    });
 }
 
 /**
@@ -418,34 +560,29 @@ void ContentPane::on_btnClean_clicked()
     if(!confirmDelete(true))
         return;
 
-    QDBusPendingReply<int> reply = serviceInterface->call("Clean",
-                    deviceInfo->device_id, currentUid, 0, -1);
-    reply.waitForFinished();
-    if (reply.isError()) {
-        qWarning() << "DBUS:" << reply.error();
-        return;
-    }
-
-
-    int result = reply.argumentAt(0).value<int>();
-    QString resultString;
-    if(result != DBUS_RESULT_SUCCESS)
-        resultString = tr("Clean Failed: ") + getErrorMessage(DELETE, result);
-    else
-        resultString = tr("Clean successfully");
-
-    //如果清除成功，则更新特征列表
-    if(result == DBUS_RESULT_SUCCESS) {
-        showFeatures();
-        updateButtonUsefulness();
-    }
+    setCursor(Qt::WaitCursor);
+    watchReply(serviceInterface->Clean(deviceInfo.device_id, currentUid, 0, -1),
+               this, [this](const QDBusPendingReply<int> &reply) {
+        setCursor(Qt::ArrowCursor);
+        if (reply.isError()) {
+            qWarning() << "DBUS:" << reply.error();
+            return;
+        }
 
-    MessageDialog msgDialog(MessageDialog::Normal,"","",this);
-    msgDialog.setTitle(tr("Clean Result"));
-    msgDialog.setWindowTitle(tr("Clean Result"));
-    msgDialog.setMessage(resultString);
-    msgDialog.exec();
+        int result = reply.value();
+        //如果清除成功，则更新特征列表
+        if(result == DBUS_RESULT_SUCCESS) {
+            refreshFeatures();
+            updateButtonUsefulness();
+            showMessage(MessageDialog::Normal, tr("Clean Result"), tr("Clean successfully"));
+            return;
+        }
 
+        getErrorMessage(DELETE, result, [this](const QString &errorMessage) {
+            showMessage(MessageDialog::Normal, tr("Clean Result"),
+                        tr("Clean Failed: ") + errorMessage);
+        });
+    });
 }
 
 /**
@@ -461,11 +598,11 @@ void ContentPane::on_btnVerify_clicked()
 
 
     if(!currentModelIndex.isValid() || !selected){
-        MessageDialog msgDialog(MessageDialog::Normal,"","",this);
-        msgDialog.setTitle(tr("Feature Verify"));
-        msgDialog.setWindowTitle(tr("Feature Verify"));
-        msgDialog.setMessage(tr("Please select the feature you want to verify."));
-        msgDialog.exec();
+        PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(MessageDialog::Normal));
+        msgDialog->setTitle(tr("Feature Verify"));
+        msgDialog->setWindowTitle(tr("Feature Verify"));
+        msgDialog->setMessage(tr("Please select the feature you want to verify."));
+        msgDialog->exec();
 
         return;
     }
@@ -473,15 +610,16 @@ void ContentPane::on_btnVerify_clicked()
     verifyIndex = currentModelIndex.data(Qt::UserRole).toInt();
     uid = currentModelIndex.data(TreeModel::UidRole).toInt();
 
-    promptDialog = new PromptDialog(serviceInterface, deviceInfo->biotype,
-                                    deviceInfo->device_id, currentUid, this);
-    if(deviceInfo->device_shortname == "huawei"){
+    promptDialog = DialogPool::instance()->acquirePromptDialog(deviceInfo.biotype,
+                                                               deviceInfo.device_id, currentUid);
+    if(deviceInfo.device_shortname == "huawei"){
         promptDialog->setProcessed(true);
     }
 
-    promptDialog->verify(deviceInfo->device_id, uid, verifyIndex);
+    promptDialog->verify(deviceInfo.device_id, uid, verifyIndex);
 \
-    delete promptDialog;
+    DialogPool::instance()->release(promptDialog);
+    promptDialog = nullptr;
 }
 
 
@@ -490,11 +628,12 @@ void ContentPane::on_btnVerify_clicked()
  */
 void ContentPane::on_btnSearch_clicked()
 {
-    promptDialog = new PromptDialog(serviceInterface, deviceInfo->biotype,
-                                    deviceInfo->device_id, currentUid, this);
-    promptDialog->search(deviceInfo->device_id, currentUid, 0, -1);
+    promptDialog = DialogPool::instance()->acquirePromptDialog(deviceInfo.biotype,
+                                                               deviceInfo.device_id, currentUid);
+    promptDialog->search(deviceInfo.device_id, currentUid, 0, -1);
 
-    delete promptDialog;
+    DialogPool::instance()->release(promptDialog);
+    promptDialog = nullptr;
 }
 
 /**
@@ -512,51 +651,77 @@ void ContentPane::on_treeView_doubleClicked(const QModelIndex &index)
             return;
     }
 
-    int idx = index.data(TreeModel::IndexRole).toInt();
-    int uid = index.data(TreeModel::UidRole).toInt();
-    QString idxName = index.data().toString();
+    QPersistentModelIndex renamedIndex(index);
+    loadAllFeatures([this, renamedIndex]{ renameFeature(renamedIndex); });
+}
+
+void ContentPane::renameFeature(const QPersistentModelIndex &renamedIndex)
+{
+    if(!renamedIndex.isValid())
+        return;
 
+    int idx = renamedIndex.data(TreeModel::IndexRole).toInt();
+    int uid = renamedIndex.data(TreeModel::UidRole).toInt();
+    QString idxName = renamedIndex.data().toString();
     QString newName = inputFeatureName(false);
     if(newName.isEmpty())
         return;
 
     qDebug() << "Rename " << idx <<idxName << " to " << newName;
 
-    QDBusReply<int> result = serviceInterface->call("Rename", deviceInfo->device_id,
-                                                    uid, idx, newName);
+    watchReply(serviceInterface->Rename(deviceInfo.device_id, uid, idx, newName),
+               this, [this, renamedIndex, newName](const QDBusPendingReply<int> &reply) {
+        if(reply.isError()) {
+            qWarning() << "DBUS:" << reply.error();
+            showMessage(MessageDialog::Error, tr("Rename Result"), tr("DBus calling error"));
+            return;
+        }
 
-    QString resultMessage;
-    int type;
-    if(result == DBUS_RESULT_SUCCESS) {
-        dataModel->setData(index, newName);
-        resultMessage = tr("Rename Successfully");
-        type = MessageDialog::Normal;
-    } else {
-        resultMessage = getErrorMessage(RENAME, result);
-        type = MessageDialog::Error;
-    }
-    MessageDialog msgDialog(type,"","",this);
-    msgDialog.setTitle(tr("Rename Result"));
-    msgDialog.setWindowTitle(tr("Rename Result"));
-    msgDialog.setMessage(resultMessage);
-    msgDialog.exec();
+        int result = reply.value();
+        if(result == DBUS_RESULT_SUCCESS) {
+            if(renamedIndex.isValid())
+                dataModel->setData(renamedIndex, newName);
+            showMessage(MessageDialog::Normal, tr("Rename Result"), tr("Rename Successfully"));
+            return;
+        }
+
+        getErrorMessage(RENAME, result, [this](const QString &errorMessage) {
+            showMessage(MessageDialog::Error, tr("Rename Result"), errorMessage);
+        });
+    });
 }
 
-QString ContentPane::getErrorMessage(int type, int result)
+void ContentPane::showMessage(int type, const QString &title, const QString &message)
+{
+    PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(type));
+    msgDialog->setTitle(title);
+    msgDialog->setWindowTitle(title);
+    msgDialog->setMessage(message);
+    msgDialog->exec();
+}
+
+/**
+ * @brief 获取操作失败的原因，结果通过 callback 返回
+ */
+void ContentPane::getErrorMessage(int type, int result,
+                                  const std::function<void (const QString &)> &callback)
 {
     QString errorMessage;
 
     switch(result) {
     case DBUS_RESULT_ERROR: {
         //操作失败，需要进一步获取失败原因
-        QDBusMessage msg = serviceInterface->call("GetNotifyMesg", deviceInfo->device_id);
-        if(msg.type() == QDBusMessage::ErrorMessage){
-            qWarning() << QString("GetNotifyMesg(%1)").arg(deviceInfo->device_id) << msg.errorMessage();
-            return tr("DBus calling error");
-        }
-
-        errorMessage = msg.arguments().at(0).toString();
-        break;
+        int drvId = deviceInfo.device_id;
+        watchReply(serviceInterface->GetNotifyMesg(drvId), this,
+                   [drvId, callback](const QDBusPendingReply<QString> &msg) {
+            if(msg.isError()){
+                qWarning() << QString("GetNotifyMesg(%1)").arg(drvId) << msg.error().message();
+                callback(tr("DBus calling error"));
+                return;
+            }
+            callback(msg.value());
+        });
+        return;
     }
     case DBUS_RESULT_DEVICEBUSY:
         //设备忙
@@ -571,5 +736,5 @@ QString ContentPane::getErrorMessage(int type, int result)
         errorMessage = (tr("Permission denied"));
         break;
     }
-    return errorMessage;
+    callback(errorMessage);
 }
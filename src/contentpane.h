@@ -20,10 +20,12 @@
 
 #include <QWidget>
 #include <QStandardItemModel>
+#include <functional>
 #include "customtype.h"
 #include "promptdialog.h"
 #include "treemodel.h"
 
+class BiometricProxy;
 namespace Ui {
 class ContentPane;
 }
@@ -33,11 +35,15 @@ class ContentPane : public QWidget
 	Q_OBJECT
 
 public:
-    explicit ContentPane(int uid, DeviceInfo *deviceInfo, QWidget *parent = 0);
+    explicit ContentPane(int uid, const DeviceInfo &deviceInfo, QWidget *parent = 0);
 	~ContentPane();
 
 signals:
     void changeDeviceStatus(DeviceInfo *deviceInfo);
+    void featuresLoaded();
+
+protected:
+    void showEvent(QShowEvent *event);
 
 /* Qt Slots */
 private slots:
@@ -58,20 +64,32 @@ private:
 	void updateButtonUsefulness();
     FeatureInfo *createNewFeatureInfo();
     QString inputFeatureName(bool isNew);
-    QString getErrorMessage(int, int);
+    void getErrorMessage(int type, int result,
+                         const std::function<void (const QString &)> &callback);
     bool confirmDelete(bool all);
+    void deleteNextFeature();
+    void showMessage(int type, const QString &title, const QString &message);
+    void loadAllFeatures(const std::function<void ()> &callback);
+    void enrollFeature();
+    void renameFeature(const QPersistentModelIndex &index);
 
     enum{DELETE, CLEAN, RENAME};
 
 public:
     void setDeviceAvailable(int deviceAvailable);
-    void setDeviceInfo(DeviceInfo *deviceInfo);
+    void setDeviceInfo(const DeviceInfo &deviceInfo);
     int featuresCount();
     void showFeatures();
+    void refreshFeatures();
+    bool prefetchFeatures();
 
 /* DBus */
+private:
+    typedef QDBusPendingReply<int, QList<QDBusVariant> > FeatureListReply;
+    void fetchFeatures(int idxStart, int idxEnd);
+    void showFeaturesCallback(const FeatureListReply &reply);
+
 private slots:
-    void showFeaturesCallback(QDBusMessage callbackReply);
 	void errorCallback(QDBusError error);
 
 /* Members */
@@ -80,8 +98,8 @@ private slots:
 private:
 	Ui::ContentPane *ui;
 	/* 用于和远端 DBus 对象交互的代理接口 */
-    QDBusInterface *serviceInterface;
-	DeviceInfo *deviceInfo;
+    BiometricProxy *serviceInterface;
+	DeviceInfo deviceInfo;
     int currentUid;
     TreeModel *dataModel;
     int freeIndex; /* 录入时所用的空闲的特征 index */
@@ -89,6 +107,22 @@ private:
 	/* 进度提示弹框 */
 	PromptDialog *promptDialog;
 	QString promptDialogGIF;
+    /* 待删除的特征，逐个提交给服务 */
+    struct DeleteTask {
+        int uid;
+        int idxStart;
+        int idxEnd;
+        QString featureName;
+    };
+    QList<DeleteTask> deleteTasks;
+    QStringList deleteResults;
+    bool hasDeleteSuccess;
+    /* 特征列表在页面第一次显示（或空闲预取）时才向服务查询 */
+    bool featuresRequested;
+    /* 每次重新加载时递增，丢弃上一轮还未返回的分页结果 */
+    int fetchGeneration;
+    /* 等待剩余特征全部加载后执行的操作 */
+    QList<std::function<void ()>> allLoadedCallbacks;
 };
 
 #endif // CONTENTPANE_H
@@ -168,6 +168,59 @@ Q_DECLARE_METATYPE(SearchResult)
 QDBusArgument &operator<<(QDBusArgument &argument, const SearchResult &ret);
 const QDBusArgument &operator>>(const QDBusArgument &argument, SearchResult &ret);
 
+template <typename T>
+void decodeVariant(const QDBusVariant &item, T &element)
+{
+    const QVariant &variant = item.variant();
+    if(variant.userType() == qMetaTypeId<T>())
+        element = variant.value<T>();
+    else
+        variant.value<QDBusArgument>() >> element;
+}
+
+/**
+ * @brief 把应答中类型为 av 的参数直接解码成连续存储的结构体数组
+ * @param reply     DBus 应答消息
+ * @param argIndex  av 参数的位置
+ * @param sizeHint  预分配的元素个数，一般是应答中的结果个数
+ *
+ * 不经过 QList<QDBusVariant> 中间容器，逐个元素从 QDBusArgument 中取出，
+ * 也不再为每个元素单独分配内存
+ */
+template <typename T>
+QVector<T> decodeVariantArray(const QDBusMessage &reply, int argIndex, int sizeHint = 0)
+{
+    QVector<T> result;
+    QList<QVariant> arguments = reply.arguments();
+    if(argIndex >= arguments.size())
+        return result;
+
+    result.reserve(qMax(sizeHint, 0));
+    const QVariant &value = arguments.at(argIndex);
+
+    /* 进程内的本地调用不经过序列化，参数仍是 QList<QDBusVariant> */
+    if(value.userType() != qMetaTypeId<QDBusArgument>()) {
+        for(const QDBusVariant &item : qdbus_cast<QList<QDBusVariant> >(value)) {
+            T element;
+            decodeVariant(item, element);
+            result.append(element);
+        }
+        return result;
+    }
+
+    const QDBusArgument argument = value.value<QDBusArgument>();
+    argument.beginArray();
+    while(!argument.atEnd()) {
+        QDBusVariant item;
+        argument >> item;
+        T element;
+        decodeVariant(item, element);
+        result.append(element);
+    }
+    argument.endArray();
+    return result;
+}
+
 class EnumToString : public QObject
 {
     Q_OBJECT
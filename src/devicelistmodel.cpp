@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "devicelistmodel.h"
+#include <QColor>
+#include "deviceregistry.h"
+
+DeviceListModel::DeviceListModel(DeviceRegistry *registry, QObject *parent)
+    : QAbstractListModel(parent),
+      registry(registry)
+{
+    for(DeviceInfo *deviceInfo : registry->devices())
+        deviceIds.append(deviceInfo->device_id);
+
+    connect(registry, &DeviceRegistry::deviceAdded, this, &DeviceListModel::onDeviceAdded);
+    connect(registry, &DeviceRegistry::deviceChanged, this, &DeviceListModel::onDeviceChanged);
+    connect(registry, &DeviceRegistry::deviceRemoved, this, &DeviceListModel::onDeviceRemoved);
+}
+
+int DeviceListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return deviceIds.size();
+}
+
+QVariant DeviceListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= deviceIds.size())
+        return QVariant();
+
+    DeviceInfo *deviceInfo = registry->device(deviceIds.at(index.row()));
+    if(!deviceInfo)
+        return QVariant();
+
+    switch(role) {
+    case Qt::DisplayRole:
+        return deviceInfo->device_shortname;
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    case Qt::ForegroundRole:
+        /* 选中时使用样式表中的颜色 */
+        return deviceInfo->device_available > 0 ? QVariant() : QColor(Qt::gray);
+    case DeviceIdRole:
+        return deviceInfo->device_id;
+    case BiotypeRole:
+        return deviceInfo->biotype;
+    case AvailableRole:
+        return deviceInfo->device_available > 0;
+    }
+    return QVariant();
+}
+
+void DeviceListModel::onDeviceAdded(DeviceInfo *deviceInfo)
+{
+    beginInsertRows(QModelIndex(), deviceIds.size(), deviceIds.size());
+    deviceIds.append(deviceInfo->device_id);
+    endInsertRows();
+}
+
+void DeviceListModel::onDeviceChanged(DeviceInfo *deviceInfo)
+{
+    int row = deviceIds.indexOf(deviceInfo->device_id);
+    if(row >= 0)
+        Q_EMIT dataChanged(index(row), index(row));
+}
+
+void DeviceListModel::onDeviceRemoved(DeviceInfo *deviceInfo)
+{
+    int row = deviceIds.indexOf(deviceInfo->device_id);
+    if(row < 0)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    deviceIds.removeAt(row);
+    endRemoveRows();
+}
+
+
+DeviceFilterModel::DeviceFilterModel(int biotype, QObject *parent)
+    : QSortFilterProxyModel(parent),
+      biotype(biotype)
+{
+    /* 设备连接状态变化时自动重新排序 */
+    setDynamicSortFilter(true);
+    sort(0);
+}
+
+QModelIndex DeviceFilterModel::indexOfDevice(int deviceId) const
+{
+    for(int row = 0; row < rowCount(); row++) {
+        QModelIndex idx = index(row, 0);
+        if(idx.data(DeviceListModel::DeviceIdRole).toInt() == deviceId)
+            return idx;
+    }
+    return QModelIndex();
+}
+
+bool DeviceFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+    return idx.data(DeviceListModel::BiotypeRole).toInt() == biotype;
+}
+
+bool DeviceFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    bool leftAvailable = left.data(DeviceListModel::AvailableRole).toBool();
+    bool rightAvailable = right.data(DeviceListModel::AvailableRole).toBool();
+    if(leftAvailable != rightAvailable)
+        return leftAvailable;
+
+    return QString::localeAwareCompare(left.data().toString(), right.data().toString()) < 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef DEVICELISTMODEL_H
+#define DEVICELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QList>
+#include "customtype.h"
+
+class DeviceRegistry;
+
+/**
+ * @brief 所有设备的列表，跟随 DeviceRegistry 增量更新
+ */
+class DeviceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum DeviceRoles {
+        DeviceIdRole = Qt::UserRole,
+        BiotypeRole,
+        AvailableRole
+    };
+
+    explicit DeviceListModel(DeviceRegistry *registry, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+
+private slots:
+    void onDeviceAdded(DeviceInfo *deviceInfo);
+    void onDeviceChanged(DeviceInfo *deviceInfo);
+    void onDeviceRemoved(DeviceInfo *deviceInfo);
+
+private:
+    DeviceRegistry *registry;
+    QList<int> deviceIds;
+};
+
+/**
+ * @brief 某一种生物特征的设备，已连接的在前，其次按名称排序
+ */
+class DeviceFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit DeviceFilterModel(int biotype, QObject *parent = nullptr);
+
+    QModelIndex indexOfDevice(int deviceId) const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
+
+private:
+    int biotype;
+};
+
+#endif // DEVICELISTMODEL_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "deviceregistry.h"
+#include <QDebug>
+
+DeviceRegistry::DeviceRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DeviceRegistry::~DeviceRegistry()
+{
+    qDeleteAll(deviceList);
+}
+
+DeviceInfo *DeviceRegistry::device(int deviceId) const
+{
+    return deviceTable.value(deviceId, nullptr);
+}
+
+/**
+ * @brief 热插拔时只更新设备的连接状态，不需要重新获取设备列表
+ * @return 状态是否有变化
+ */
+bool DeviceRegistry::setDeviceAvailable(int deviceId, int deviceAvailable)
+{
+    DeviceInfo *deviceInfo = device(deviceId);
+    if(!deviceInfo || deviceInfo->device_available == deviceAvailable)
+        return false;
+
+    deviceInfo->device_available = deviceAvailable;
+    Q_EMIT deviceChanged(deviceInfo);
+    return true;
+}
+
+QList<DeviceInfo *> DeviceRegistry::devices() const
+{
+    return deviceList;
+}
+
+int DeviceRegistry::count() const
+{
+    return deviceList.size();
+}
+
+bool DeviceRegistry::sameDevice(const DeviceInfo &lhs, const DeviceInfo &rhs)
+{
+    return lhs.device_id == rhs.device_id &&
+            lhs.device_shortname == rhs.device_shortname &&
+            lhs.device_fullname == rhs.device_fullname &&
+            lhs.driver_enable == rhs.driver_enable &&
+            lhs.device_available == rhs.device_available &&
+            lhs.biotype == rhs.biotype &&
+            lhs.stotype == rhs.stotype &&
+            lhs.eigtype == rhs.eigtype &&
+            lhs.vertype == rhs.vertype &&
+            lhs.idtype == rhs.idtype &&
+            lhs.bustype == rhs.bustype &&
+            lhs.dev_status == rhs.dev_status &&
+            lhs.ops_status == rhs.ops_status;
+}
+
+/**
+ * @brief 用新的设备列表更新设备表
+ * 生物特征类型变化的设备按先删除后添加处理，使用者不用在两个页面之间移动设备。
+ */
+void DeviceRegistry::reconcile(const QVector<DeviceInfo> &snapshot)
+{
+    /* 重复的 id 只保留第一个，删除和更新两步使用同一份结果 */
+    QHash<int, const DeviceInfo *> incoming;
+    QList<const DeviceInfo *> uniqueSnapshot;
+    uniqueSnapshot.reserve(snapshot.size());
+    for(const DeviceInfo &deviceInfo : snapshot) {
+        if(incoming.contains(deviceInfo.device_id))
+            continue;
+        incoming.insert(deviceInfo.device_id, &deviceInfo);
+        uniqueSnapshot.append(&deviceInfo);
+    }
+
+    /* 先处理删除，避免同名设备以新 id 出现时短暂并存 */
+    for(auto iter = deviceList.begin(); iter != deviceList.end(); ) {
+        DeviceInfo *deviceInfo = *iter;
+        const DeviceInfo *newInfo = incoming.value(deviceInfo->device_id, nullptr);
+        if(newInfo && newInfo->biotype == deviceInfo->biotype) {
+            ++iter;
+            continue;
+        }
+        qDebug() << "device removed:" << deviceInfo->device_id << deviceInfo->device_shortname;
+        iter = deviceList.erase(iter);
+        deviceTable.remove(deviceInfo->device_id);
+        Q_EMIT deviceRemoved(deviceInfo);
+        delete deviceInfo;
+    }
+
+    QList<DeviceInfo *> ordered;
+    ordered.reserve(uniqueSnapshot.size());
+    for(const DeviceInfo *newInfoPtr : uniqueSnapshot) {
+        const DeviceInfo &newInfo = *newInfoPtr;
+        DeviceInfo *deviceInfo = deviceTable.value(newInfo.device_id, nullptr);
+        if(!deviceInfo) {
+            deviceInfo = new DeviceInfo(newInfo);
+            deviceTable.insert(deviceInfo->device_id, deviceInfo);
+            ordered.append(deviceInfo);
+            Q_EMIT deviceAdded(deviceInfo);
+        } else {
+            ordered.append(deviceInfo);
+            if(!sameDevice(*deviceInfo, newInfo)) {
+                *deviceInfo = newInfo;
+                Q_EMIT deviceChanged(deviceInfo);
+            }
+        }
+    }
+    deviceList = ordered;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef DEVICEREGISTRY_H
+#define DEVICEREGISTRY_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "customtype.h"
+
+/**
+ * @brief 以 device_id 为键的设备表
+ *
+ * 每次 GetDrvList 的结果通过 reconcile 合并进来：已有设备原地更新，
+ * 只对新增、删除和内容有变化的设备发出信号，设备对象的地址在其存在期间保持不变。
+ */
+class DeviceRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DeviceRegistry(QObject *parent = nullptr);
+    ~DeviceRegistry();
+
+    void reconcile(const QVector<DeviceInfo> &snapshot);
+    DeviceInfo *device(int deviceId) const;
+    bool setDeviceAvailable(int deviceId, int deviceAvailable);
+    QList<DeviceInfo *> devices() const;
+    int count() const;
+
+signals:
+    void deviceAdded(DeviceInfo *deviceInfo);
+    void deviceChanged(DeviceInfo *deviceInfo);
+    /* 发出信号后设备对象即被释放 */
+    void deviceRemoved(DeviceInfo *deviceInfo);
+
+private:
+    static bool sameDevice(const DeviceInfo &lhs, const DeviceInfo &rhs);
+
+private:
+    QList<DeviceInfo *> deviceList;         //按服务返回的顺序
+    QHash<int, DeviceInfo *> deviceTable;   //device_id -> 设备
+};
+
+#endif // DEVICEREGISTRY_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#include "devicesignalrouter.h"
+#include <QDBusConnection>
+#include <QDebug>
+#include "biometricproxy.h"
+
+DeviceSignalRouter *DeviceSignalRouter::instance_ = nullptr;
+
+DeviceSignalRouter::DeviceSignalRouter(QObject *parent)
+    : QObject(parent),
+      subscribed(false)
+{
+}
+
+DeviceSignalRouter *DeviceSignalRouter::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new DeviceSignalRouter;
+    }
+    return instance_;
+}
+
+/**
+ * @brief 登记设备信号的处理函数
+ * context 被销毁时自动注销
+ */
+void DeviceSignalRouter::addHandler(int deviceId, QObject *context,
+                                    const StatusHandler &statusHandler,
+                                    const ProcessHandler &processHandler)
+{
+    handlers[deviceId].append(Handler{context, statusHandler, processHandler});
+    connect(context, &QObject::destroyed,
+            this, &DeviceSignalRouter::removeHandlers, Qt::UniqueConnection);
+
+    subscribe();
+}
+
+void DeviceSignalRouter::removeHandlers(QObject *context)
+{
+    for(auto iter = handlers.begin(); iter != handlers.end(); ) {
+        QVector<Handler> &list = iter.value();
+        for(int i = list.size() - 1; i >= 0; i--)
+            if(list[i].context == context || list[i].context.isNull())
+                list.remove(i);
+
+        if(list.isEmpty())
+            iter = handlers.erase(iter);
+        else
+            ++iter;
+    }
+
+    if(handlers.isEmpty())
+        unsubscribe();
+}
+
+void DeviceSignalRouter::subscribe()
+{
+    if(subscribed)
+        return;
+
+    QDBusConnection connection = BiometricProxy::busConnection();
+    connection.connect(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "StatusChanged",
+                       this, SLOT(onStatusChanged(int,int)));
+    connection.connect(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "ProcessChanged",
+                       this, SLOT(onProcessChanged(int,QString,int,QString)));
+    subscribed = true;
+}
+
+void DeviceSignalRouter::unsubscribe()
+{
+    if(!subscribed)
+        return;
+
+    QDBusConnection connection = BiometricProxy::busConnection();
+    connection.disconnect(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "StatusChanged",
+                          this, SLOT(onStatusChanged(int,int)));
+    connection.disconnect(DBUS_SERVICE, DBUS_PATH, DBUS_INTERFACE, "ProcessChanged",
+                          this, SLOT(onProcessChanged(int,QString,int,QString)));
+    subscribed = false;
+}
+
+void DeviceSignalRouter::onStatusChanged(int drvid, int status)
+{
+    /* 处理函数中可能注销自己，遍历副本 */
+    const QVector<Handler> list = handlers.value(drvid);
+    for(const Handler &handler : list)
+        if(handler.context && handler.statusHandler)
+            handler.statusHandler(status);
+}
+
+void DeviceSignalRouter::onProcessChanged(int drvid, const QString &aa,
+                                          int statusType, const QString &bb)
+{
+    const QVector<Handler> list = handlers.value(drvid);
+    for(const Handler &handler : list)
+        if(handler.context && handler.processHandler)
+            handler.processHandler(aa, statusType, bb);
+}
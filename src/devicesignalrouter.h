@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#ifndef DEVICESIGNALROUTER_H
+#define DEVICESIGNALROUTER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QPointer>
+#include <functional>
+
+/**
+ * @brief 按 device_id 分发服务的 StatusChanged、ProcessChanged 信号
+ *
+ * 所有设备共用一次订阅，收到信号后只调用登记了该设备的处理函数，
+ * 不再由每个监听者各自过滤。drvid 是整数，DBus 的 arg0 匹配规则只能匹配字符串，
+ * 所以无法让总线按设备过滤；这里只在有处理函数登记时才订阅，没有时取消订阅，
+ * 空闲时总线不会因为这些信号唤醒本进程。
+ */
+class DeviceSignalRouter : public QObject
+{
+    Q_OBJECT
+private:
+    explicit DeviceSignalRouter(QObject *parent = nullptr);
+    DeviceSignalRouter(const DeviceSignalRouter &router) = delete;
+    DeviceSignalRouter& operator =(const DeviceSignalRouter &rhs) = delete;
+
+public:
+    typedef std::function<void (int status)> StatusHandler;
+    typedef std::function<void (const QString &aa, int statusType,
+                                const QString &bb)> ProcessHandler;
+
+    static DeviceSignalRouter *instance();
+    void addHandler(int deviceId, QObject *context,
+                    const StatusHandler &statusHandler,
+                    const ProcessHandler &processHandler = ProcessHandler());
+    void removeHandlers(QObject *context);
+
+private slots:
+    void onStatusChanged(int drvid, int status);
+    void onProcessChanged(int drvid, const QString &aa, int statusType, const QString &bb);
+
+private:
+    void subscribe();
+    void unsubscribe();
+
+private:
+    struct Handler {
+        QPointer<QObject> context;
+        StatusHandler statusHandler;
+        ProcessHandler processHandler;
+    };
+    static DeviceSignalRouter *instance_;
+    QHash<int, QVector<Handler>> handlers;  //device_id -> 处理函数
+    bool subscribed;
+};
+
+#endif // DEVICESIGNALROUTER_H
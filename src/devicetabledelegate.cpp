@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "devicetabledelegate.h"
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+#include "devicetablemodel.h"
+
+#define SWITCH_WIDTH    40
+#define SWITCH_HEIGHT   20
+
+DeviceTableDelegate::DeviceTableDelegate(QObject *parent)
+    : QStyledItemDelegate(parent),
+      switchOpen(":/images/assets/switch_open_small.png"),
+      switchClose(":/images/assets/switch_close_small.png")
+{
+}
+
+QRect DeviceTableDelegate::switchRect(const QStyleOptionViewItem &option) const
+{
+    return QStyle::alignedRect(option.direction, Qt::AlignCenter,
+                               QSize(SWITCH_WIDTH, SWITCH_HEIGHT), option.rect);
+}
+
+QRect DeviceTableDelegate::checkBoxRect(const QStyleOptionViewItem &option) const
+{
+    QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+    QSize size(style->pixelMetric(QStyle::PM_IndicatorWidth, &option, option.widget),
+               style->pixelMetric(QStyle::PM_IndicatorHeight, &option, option.widget));
+    return QStyle::alignedRect(option.direction, Qt::AlignCenter, size, option.rect);
+}
+
+void DeviceTableDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                const QModelIndex &index) const
+{
+    int column = index.column() % DeviceTableModel::ColumnsPerDevice;
+
+    /* 左右两组设备之间的分隔线 */
+    if(index.column() == DeviceTableModel::DefaultColumn) {
+        painter->save();
+        painter->setPen(QColor(Qt::lightGray));
+        painter->drawLine(option.rect.topRight(), option.rect.bottomRight());
+        painter->restore();
+    }
+
+    if(!index.data(DeviceTableModel::DeviceIdRole).isValid())
+        return;
+
+    if(column == DeviceTableModel::DriverColumn) {
+        bool enable = index.data(DeviceTableModel::DriverEnableRole).toBool();
+        bool pending = index.data(DeviceTableModel::DriverPendingRole).toBool();
+        painter->save();
+        /* 还没有应用的修改画成半透明 */
+        if(pending)
+            painter->setOpacity(0.5);
+        painter->drawPixmap(switchRect(option), enable ? switchOpen : switchClose);
+        painter->restore();
+        return;
+    }
+
+    if(column == DeviceTableModel::DefaultColumn) {
+        QStyleOptionButton buttonOption;
+        buttonOption.rect = checkBoxRect(option);
+        buttonOption.state = QStyle::State_Enabled;
+        if(index.data(Qt::CheckStateRole).toInt() == Qt::Checked)
+            buttonOption.state |= QStyle::State_On;
+        else
+            buttonOption.state |= QStyle::State_Off;
+        if(option.state & QStyle::State_MouseOver)
+            buttonOption.state |= QStyle::State_MouseOver;
+
+        QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+        style->drawPrimitive(QStyle::PE_IndicatorCheckBox, &buttonOption, painter, option.widget);
+        return;
+    }
+
+    QStyledItemDelegate::paint(painter, option, index);
+}
+
+bool DeviceTableDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                      const QStyleOptionViewItem &option,
+                                      const QModelIndex &index)
+{
+    int column = index.column() % DeviceTableModel::ColumnsPerDevice;
+    if(column != DeviceTableModel::DriverColumn && column != DeviceTableModel::DefaultColumn)
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+
+    if(!index.data(DeviceTableModel::DeviceIdRole).isValid())
+        return false;
+
+    if(event->type() != QEvent::MouseButtonRelease)
+        return event->type() == QEvent::MouseButtonPress ||
+                event->type() == QEvent::MouseButtonDblClick;
+
+    QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+    if(mouseEvent->button() != Qt::LeftButton)
+        return false;
+
+    if(column == DeviceTableModel::DriverColumn) {
+        if(switchRect(option).contains(mouseEvent->pos()))
+            Q_EMIT driverSwitchClicked(index);
+        return true;
+    }
+
+    if(checkBoxRect(option).contains(mouseEvent->pos())) {
+        bool checked = index.data(Qt::CheckStateRole).toInt() == Qt::Checked;
+        model->setData(index, checked ? Qt::Unchecked : Qt::Checked, Qt::CheckStateRole);
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef DEVICETABLEDELEGATE_H
+#define DEVICETABLEDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPixmap>
+
+/**
+ * @brief 绘制设备表格中的驱动开关和默认设备复选框
+ *
+ * 开关和复选框直接画在单元格里，不为每个设备创建控件；点击通过 editorEvent 处理。
+ */
+class DeviceTableDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit DeviceTableDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const;
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option, const QModelIndex &index);
+
+signals:
+    void driverSwitchClicked(const QModelIndex &index);
+
+private:
+    QRect switchRect(const QStyleOptionViewItem &option) const;
+    QRect checkBoxRect(const QStyleOptionViewItem &option) const;
+
+private:
+    QPixmap switchOpen;
+    QPixmap switchClose;
+};
+
+#endif // DEVICETABLEDELEGATE_H
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "devicetablemodel.h"
+#include <QColor>
+#include <QTimer>
+#include "deviceregistry.h"
+#include "configuration.h"
+
+#define DEVICES_PER_ROW 2
+
+DeviceTableModel::DeviceTableModel(DeviceRegistry *registry, QObject *parent)
+    : QAbstractTableModel(parent),
+      registry(registry),
+      biotype_(-1),
+      refreshScheduled(false)
+{
+    defaultDevice = Configuration::instance()->getDefaultDevice();
+
+    /* 一次合并可能产生多个设备信号，合并为一次刷新 */
+    connect(registry, &DeviceRegistry::deviceAdded, this, &DeviceTableModel::scheduleRefresh);
+    connect(registry, &DeviceRegistry::deviceChanged, this, &DeviceTableModel::scheduleRefresh);
+    connect(registry, &DeviceRegistry::deviceRemoved, this, &DeviceTableModel::scheduleRefresh);
+    connect(Configuration::instance(), &Configuration::defaultDeviceChanged,
+            this, &DeviceTableModel::onDefaultDeviceChanged);
+}
+
+void DeviceTableModel::setBiotype(int biotype)
+{
+    if(biotype_ == biotype)
+        return;
+
+    beginResetModel();
+    biotype_ = biotype;
+    deviceIds = filteredDevices();
+    endResetModel();
+}
+
+int DeviceTableModel::biotype() const
+{
+    return biotype_;
+}
+
+QList<int> DeviceTableModel::filteredDevices() const
+{
+    QList<int> available, unavailable;
+    for(DeviceInfo *deviceInfo : registry->devices()) {
+        if(deviceInfo->biotype != biotype_)
+            continue;
+        if(deviceInfo->device_available > 0)
+            available.append(deviceInfo->device_id);
+        else
+            unavailable.append(deviceInfo->device_id);
+    }
+    return available + unavailable;
+}
+
+void DeviceTableModel::scheduleRefresh()
+{
+    if(refreshScheduled)
+        return;
+    refreshScheduled = true;
+    QTimer::singleShot(0, this, &DeviceTableModel::refresh);
+}
+
+/**
+ * @brief 设备信息变化后更新表格
+ * 设备和顺序都没变时只通知数据变化，否则重置模型（表格中没有控件，重置的代价很小）
+ */
+void DeviceTableModel::refresh()
+{
+    refreshScheduled = false;
+
+    /* 设备已不存在或者已经是目标状态的修改不再需要应用 */
+    int pendingCount = pendingDrivers_.size();
+    for(auto iter = pendingDrivers_.begin(); iter != pendingDrivers_.end(); ) {
+        DeviceInfo *deviceInfo = registry->device(iter.key());
+        if(!deviceInfo || (deviceInfo->driver_enable > 0) == iter.value())
+            iter = pendingDrivers_.erase(iter);
+        else
+            ++iter;
+    }
+    if(pendingDrivers_.size() != pendingCount)
+        Q_EMIT pendingDriversChanged(pendingDrivers_.size());
+
+    QList<int> ids = filteredDevices();
+    if(ids == deviceIds) {
+        if(rowCount() > 0)
+            Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+        return;
+    }
+
+    beginResetModel();
+    deviceIds = ids;
+    endResetModel();
+}
+
+/**
+ * @brief 切换一个设备待应用的驱动状态，切换回当前状态时取消这个修改
+ */
+void DeviceTableModel::togglePendingDriver(const QModelIndex &index)
+{
+    DeviceInfo *deviceInfo = deviceAt(index);
+    if(!deviceInfo)
+        return;
+
+    int deviceId = deviceInfo->device_id;
+    bool enable = deviceInfo->driver_enable > 0;
+    bool target = !pendingDrivers_.value(deviceId, enable);
+    if(target == enable)
+        pendingDrivers_.remove(deviceId);
+    else
+        pendingDrivers_.insert(deviceId, target);
+
+    Q_EMIT dataChanged(index, index, {DriverEnableRole, DriverPendingRole});
+    Q_EMIT pendingDriversChanged(pendingDrivers_.size());
+}
+
+QHash<int, bool> DeviceTableModel::pendingDrivers() const
+{
+    return pendingDrivers_;
+}
+
+void DeviceTableModel::clearPendingDrivers()
+{
+    if(pendingDrivers_.isEmpty())
+        return;
+    pendingDrivers_.clear();
+    if(rowCount() > 0)
+        Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    Q_EMIT pendingDriversChanged(0);
+}
+
+void DeviceTableModel::removePendingDrivers(const QList<int> &deviceIds)
+{
+    int pendingCount = pendingDrivers_.size();
+    for(int deviceId : deviceIds)
+        pendingDrivers_.remove(deviceId);
+    if(pendingDrivers_.size() == pendingCount)
+        return;
+
+    if(rowCount() > 0)
+        Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    Q_EMIT pendingDriversChanged(pendingDrivers_.size());
+}
+
+void DeviceTableModel::onDefaultDeviceChanged(const QString &deviceName)
+{
+    defaultDevice = deviceName;
+    for(int row = 0; row < rowCount(); row++)
+        for(int i = 0; i < DEVICES_PER_ROW; i++) {
+            QModelIndex idx = index(row, i * ColumnsPerDevice + DefaultColumn);
+            Q_EMIT dataChanged(idx, idx, {Qt::CheckStateRole});
+        }
+}
+
+int DeviceTableModel::deviceRow(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return -1;
+    int pos = index.row() * DEVICES_PER_ROW + index.column() / ColumnsPerDevice;
+    return pos < deviceIds.size() ? pos : -1;
+}
+
+DeviceInfo *DeviceTableModel::deviceAt(const QModelIndex &index) const
+{
+    int pos = deviceRow(index);
+    if(pos < 0)
+        return nullptr;
+    return registry->device(deviceIds.at(pos));
+}
+
+int DeviceTableModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return (deviceIds.size() + DEVICES_PER_ROW - 1) / DEVICES_PER_ROW;
+}
+
+int DeviceTableModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return ColumnsPerDevice * DEVICES_PER_ROW;
+}
+
+QVariant DeviceTableModel::data(const QModelIndex &index, int role) const
+{
+    DeviceInfo *deviceInfo = deviceAt(index);
+    if(!deviceInfo)
+        return QVariant();
+
+    int column = index.column() % ColumnsPerDevice;
+    if(role == DeviceIdRole)
+        return deviceInfo->device_id;
+
+    switch(column) {
+    case NameColumn:
+        if(role == Qt::DisplayRole)
+            return "   " + deviceInfo->device_shortname;
+        if(role == Qt::TextAlignmentRole)
+            return int(Qt::AlignLeft | Qt::AlignVCenter);
+        break;
+    case StatusColumn:
+        if(role == Qt::DisplayRole)
+            return deviceInfo->device_available > 0 ? tr("Connected") : tr("Unconnected");
+        if(role == Qt::ForegroundRole)
+            return QColor(deviceInfo->device_available > 0 ? Qt::red : Qt::black);
+        if(role == Qt::TextAlignmentRole)
+            return int(Qt::AlignHCenter | Qt::AlignVCenter);
+        break;
+    case DriverColumn:
+        if(role == DriverEnableRole)
+            return pendingDrivers_.value(deviceInfo->device_id, deviceInfo->driver_enable > 0);
+        if(role == DriverPendingRole)
+            return pendingDrivers_.contains(deviceInfo->device_id);
+        break;
+    case DefaultColumn:
+        if(role == Qt::CheckStateRole)
+            return deviceInfo->device_shortname == defaultDevice ? Qt::Checked : Qt::Unchecked;
+        break;
+    }
+    return QVariant();
+}
+
+bool DeviceTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    DeviceInfo *deviceInfo = deviceAt(index);
+    if(!deviceInfo || index.column() % ColumnsPerDevice != DefaultColumn ||
+            role != Qt::CheckStateRole)
+        return false;
+
+    /* 默认设备只有一个，取消选中时清空；dataChanged 由 defaultDeviceChanged 触发 */
+    if(value.toInt() == Qt::Checked)
+        Configuration::instance()->setDefaultDevice(deviceInfo->device_shortname);
+    else
+        Configuration::instance()->setDefaultDevice("");
+    return true;
+}
+
+Qt::ItemFlags DeviceTableModel::flags(const QModelIndex &index) const
+{
+    if(!deviceAt(index))
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags flags = Qt::ItemIsEnabled;
+    if(index.column() % ColumnsPerDevice == DefaultColumn)
+        flags |= Qt::ItemIsUserCheckable;
+    return flags;
+}
+
+QVariant DeviceTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal)
+        return QVariant();
+
+    int column = section % ColumnsPerDevice;
+    if(role == Qt::TextAlignmentRole) {
+        if(column == NameColumn)
+            return int(Qt::AlignLeft | Qt::AlignVCenter);
+        return int(Qt::AlignHCenter | Qt::AlignVCenter);
+    }
+    if(role != Qt::DisplayRole)
+        return QVariant();
+
+    switch(column) {
+    case NameColumn:
+        return "    " + tr("Device Name");
+    case StatusColumn:
+        return tr("Device Status");
+    case DriverColumn:
+        return tr("Driver Status");
+    case DefaultColumn:
+        return tr("Default");
+    }
+    return QVariant();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef DEVICETABLEMODEL_H
+#define DEVICETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QHash>
+#include "customtype.h"
+
+class DeviceRegistry;
+
+/**
+ * @brief 总览页面的设备表格
+ *
+ * 每行显示两个设备，每个设备占四列：名称、设备状态、驱动状态、默认设备。
+ * 表格只保存设备 id，数据从 DeviceRegistry 中读取；切换设备类型只是更换过滤条件。
+ */
+class DeviceTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum DeviceColumn {
+        NameColumn,
+        StatusColumn,
+        DriverColumn,
+        DefaultColumn,
+        ColumnsPerDevice
+    };
+    enum DeviceRoles {
+        DeviceIdRole = Qt::UserRole,
+        DriverEnableRole,       //驱动状态，有待应用的修改时为修改后的状态
+        DriverPendingRole
+    };
+
+    explicit DeviceTableModel(DeviceRegistry *registry, QObject *parent = nullptr);
+
+    void setBiotype(int biotype);
+    int biotype() const;
+    DeviceInfo *deviceAt(const QModelIndex &index) const;
+
+    /* 批量修改驱动状态：点击开关只记录修改，统一应用 */
+    void togglePendingDriver(const QModelIndex &index);
+    QHash<int, bool> pendingDrivers() const;
+    void clearPendingDrivers();
+    void removePendingDrivers(const QList<int> &deviceIds);
+
+public:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+signals:
+    void pendingDriversChanged(int count);
+
+public slots:
+    void refresh();
+
+private slots:
+    void scheduleRefresh();
+    void onDefaultDeviceChanged(const QString &deviceName);
+
+private:
+    int deviceRow(const QModelIndex &index) const;
+    QList<int> filteredDevices() const;
+
+private:
+    DeviceRegistry *registry;
+    int biotype_;
+    QList<int> deviceIds;       //当前类型的设备，已连接的在前
+    QString defaultDevice;
+    QHash<int, bool> pendingDrivers_;   //device_id -> 修改后的驱动状态
+    bool refreshScheduled;
+};
+
+#endif // DEVICETABLEMODEL_H
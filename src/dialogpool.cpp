@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#include "dialogpool.h"
+#include <QFile>
+#include <QTimer>
+#include <QEvent>
+#include "promptdialog.h"
+#include "inputdialog.h"
+#include "messagedialog.h"
+#include "biometricproxy.h"
+
+#define POOL_MAX_IDLE   2   /* 每种对话框最多保留的空闲实例 */
+
+DialogPool *DialogPool::instance_ = nullptr;
+
+DialogPool::DialogPool(QObject *parent)
+    : QObject(parent),
+      warmStep(-1)
+{
+}
+
+DialogPool *DialogPool::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new DialogPool;
+    }
+    return instance_;
+}
+
+/**
+ * @brief 对话框共用的样式表，只读取一次
+ */
+QString DialogPool::styleSheet()
+{
+    static QString styleSheet;
+    if(styleSheet.isNull()) {
+        QFile qssFile(":/css/assets/promptdialog.qss");
+        qssFile.open(QFile::ReadOnly);
+        styleSheet = QLatin1String(qssFile.readAll());
+        qssFile.close();
+    }
+    return styleSheet;
+}
+
+/**
+ * @brief 设置池中对话框的父窗口，对话框只创建一次，不随使用者改变父窗口
+ */
+void DialogPool::setParentWidget(QWidget *parent)
+{
+    parentWidget = parent;
+}
+
+/**
+ * @brief 父窗口第一次绘制后，在空闲时逐个创建对话框
+ */
+void DialogPool::prewarm()
+{
+    if(!parentWidget || warmStep >= 0)
+        return;
+
+    warmStep = 0;
+    parentWidget->installEventFilter(this);
+}
+
+bool DialogPool::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == parentWidget && event->type() == QEvent::Paint) {
+        parentWidget->removeEventFilter(this);
+        QTimer::singleShot(0, this, &DialogPool::warmNext);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void DialogPool::warmNext()
+{
+    switch(warmStep++) {
+    case 0:
+        if(promptDialogs.isEmpty())
+            putIdle(promptDialogs, new PromptDialog(BiometricProxy::instance(), parentWidget));
+        break;
+    case 1:
+        if(inputDialogs.isEmpty())
+            putIdle(inputDialogs, new InputDialog(parentWidget));
+        break;
+    case 2:
+        if(messageDialogs.isEmpty())
+            putIdle(messageDialogs, new MessageDialog(MessageDialog::Normal, "", "", parentWidget));
+        break;
+    default:
+        return;
+    }
+    QTimer::singleShot(0, this, &DialogPool::warmNext);
+}
+
+template <typename Dialog>
+Dialog *DialogPool::takeIdle(QList<QPointer<Dialog>> &idle)
+{
+    while(!idle.isEmpty()) {
+        Dialog *dialog = idle.takeLast();
+        if(dialog)
+            return dialog;
+    }
+    return nullptr;
+}
+
+template <typename Dialog>
+void DialogPool::putIdle(QList<QPointer<Dialog>> &idle, Dialog *dialog)
+{
+    dialog->hide();
+    if(idle.size() >= POOL_MAX_IDLE) {
+        dialog->deleteLater();
+        return;
+    }
+    /* 提前完成样式表的解析 */
+    dialog->ensurePolished();
+    idle.append(dialog);
+}
+
+PromptDialog *DialogPool::acquirePromptDialog(int bioType, int deviceId, int uid)
+{
+    PromptDialog *dialog = takeIdle(promptDialogs);
+    if(!dialog)
+        dialog = new PromptDialog(BiometricProxy::instance(), parentWidget);
+    dialog->reset(bioType, deviceId, uid);
+    return dialog;
+}
+
+InputDialog *DialogPool::acquireInputDialog()
+{
+    InputDialog *dialog = takeIdle(inputDialogs);
+    if(!dialog)
+        dialog = new InputDialog(parentWidget);
+    dialog->reset();
+    return dialog;
+}
+
+MessageDialog *DialogPool::acquireMessageDialog(int type, const QString &title,
+                                                const QString &msg)
+{
+    MessageDialog *dialog = takeIdle(messageDialogs);
+    if(!dialog)
+        return new MessageDialog(type, title, msg, parentWidget);
+    dialog->reset(type, title, msg);
+    return dialog;
+}
+
+void DialogPool::release(PromptDialog *dialog)
+{
+    if(!dialog)
+        return;
+    dialog->recycle();
+    putIdle(promptDialogs, dialog);
+}
+
+void DialogPool::release(InputDialog *dialog)
+{
+    if(!dialog)
+        return;
+    /* 断开使用者连接的 dataChanged */
+    dialog->reset();
+    putIdle(inputDialogs, dialog);
+}
+
+void DialogPool::release(MessageDialog *dialog)
+{
+    if(dialog)
+        putIdle(messageDialogs, dialog);
+}
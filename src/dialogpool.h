@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#ifndef DIALOGPOOL_H
+#define DIALOGPOOL_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QWidget>
+
+class PromptDialog;
+class InputDialog;
+class MessageDialog;
+
+/**
+ * @brief PromptDialog、InputDialog、MessageDialog 的复用池
+ *
+ * 对话框的构造（setupUi、样式表、创建本地窗口、设置窗口装饰）只做一次，
+ * 使用前 reset，用完放回池中。主窗口第一次绘制后在空闲时预先创建各一个，
+ * 第一次点击录入时不再卡顿。
+ */
+class DialogPool : public QObject
+{
+    Q_OBJECT
+private:
+    explicit DialogPool(QObject *parent = nullptr);
+    DialogPool(const DialogPool &pool) = delete;
+    DialogPool& operator =(const DialogPool &rhs) = delete;
+
+public:
+    static DialogPool *instance();
+    static QString styleSheet();
+
+    void setParentWidget(QWidget *parent);
+    void prewarm();
+
+    PromptDialog *acquirePromptDialog(int bioType, int deviceId, int uid);
+    InputDialog *acquireInputDialog();
+    MessageDialog *acquireMessageDialog(int type, const QString &title = "",
+                                        const QString &msg = "");
+    void release(PromptDialog *dialog);
+    void release(InputDialog *dialog);
+    void release(MessageDialog *dialog);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+private:
+    void warmNext();
+    template <typename Dialog>
+    Dialog *takeIdle(QList<QPointer<Dialog>> &idle);
+    template <typename Dialog>
+    void putIdle(QList<QPointer<Dialog>> &idle, Dialog *dialog);
+
+private:
+    static DialogPool *instance_;
+    QPointer<QWidget> parentWidget;
+    QList<QPointer<PromptDialog>> promptDialogs;
+    QList<QPointer<InputDialog>> inputDialogs;
+    QList<QPointer<MessageDialog>> messageDialogs;
+    int warmStep;
+};
+
+/**
+ * @brief 离开作用域时把对话框放回池中，用法与栈上的对话框对象相同
+ */
+template <typename Dialog>
+class PooledDialog
+{
+public:
+    explicit PooledDialog(Dialog *dialog) : dialog(dialog) {}
+    ~PooledDialog() { DialogPool::instance()->release(dialog); }
+    PooledDialog(const PooledDialog &) = delete;
+    PooledDialog& operator =(const PooledDialog &) = delete;
+
+    Dialog *operator->() const { return dialog; }
+    Dialog *data() const { return dialog; }
+
+private:
+    Dialog *dialog;
+};
+
+#endif // DIALOGPOOL_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#include "frameanimator.h"
+#include <QLabel>
+#include <QTimer>
+#include <QEvent>
+
+FrameAnimator::FrameAnimator(QLabel *label, const AnimationPtr &animation,
+                             QObject *parent)
+    : QObject(parent),
+      label(label),
+      animation(animation),
+      timer(new QTimer(this)),
+      currentFrame(0),
+      running(false)
+{
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &FrameAnimator::nextFrame);
+
+    label->installEventFilter(this);
+    if(label->window() != label)
+        label->window()->installEventFilter(this);
+}
+
+/**
+ * @brief 更换要播放的动画，会先停止播放
+ */
+void FrameAnimator::setAnimation(const AnimationPtr &animation)
+{
+    stop();
+    this->animation = animation;
+    currentFrame = 0;
+}
+
+void FrameAnimator::start()
+{
+    if(running || !label || !animation)
+        return;
+
+    running = true;
+    showFrame();
+    updateTimer();
+}
+
+/**
+ * @brief 停止播放，label 上的内容由调用方替换
+ */
+void FrameAnimator::stop()
+{
+    running = false;
+    timer->stop();
+}
+
+bool FrameAnimator::isRunning() const
+{
+    return running;
+}
+
+bool FrameAnimator::eventFilter(QObject *watched, QEvent *event)
+{
+    switch(event->type()) {
+    case QEvent::Show:
+    case QEvent::Hide:
+    case QEvent::WindowStateChange:
+        updateTimer();
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameAnimator::showFrame()
+{
+    label->setPixmap(animation->frames.at(currentFrame));
+}
+
+void FrameAnimator::nextFrame()
+{
+    if(!running || !label)
+        return;
+
+    currentFrame = (currentFrame + 1) % animation->frames.size();
+    showFrame();
+    updateTimer();
+}
+
+/**
+ * @brief 只在播放中且 label 可见时计时
+ */
+void FrameAnimator::updateTimer()
+{
+    bool visible = label && label->isVisible() && !label->window()->isMinimized();
+    if(!running || !visible || animation->frames.size() < 2) {
+        timer->stop();
+        return;
+    }
+    if(!timer->isActive())
+        timer->start(animation->delays.at(currentFrame));
+}
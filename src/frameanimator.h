@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#ifndef FRAMEANIMATOR_H
+#define FRAMEANIMATOR_H
+
+#include <QObject>
+#include <QPointer>
+#include "imagecache.h"
+
+class QLabel;
+class QTimer;
+
+/**
+ * @brief 在 QLabel 上播放 ImageCache 中解码好的动画
+ *
+ * 帧由所有对话框共用，播放时不再解码；label 所在窗口不可见或最小化时暂停计时。
+ */
+class FrameAnimator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameAnimator(QLabel *label, const AnimationPtr &animation,
+                           QObject *parent = nullptr);
+
+    void setAnimation(const AnimationPtr &animation);
+    void start();
+    void stop();
+    bool isRunning() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+private:
+    void showFrame();
+    void nextFrame();
+    void updateTimer();
+
+private:
+    QPointer<QLabel> label;
+    AnimationPtr animation;
+    QTimer *timer;
+    int currentFrame;
+    bool running;
+};
+
+#endif // FRAMEANIMATOR_H
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#include "imagecache.h"
+#include <QGuiApplication>
+#include <QPixmapCache>
+#include <QImageReader>
+#include <QTimer>
+#include <QDebug>
+#include "customtype.h"
+
+#define IMAGE_DIR   "/usr/share/ukui-biometric/images/"
+#define DEFAULT_FRAME_DELAY 100     /* 毫秒，GIF 中没有指定帧间隔时使用 */
+
+ImageCache *ImageCache::instance_ = nullptr;
+
+ImageCache::ImageCache(QObject *parent)
+    : QObject(parent),
+      warming(false)
+{
+}
+
+ImageCache *ImageCache::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new ImageCache;
+    }
+    return instance_;
+}
+
+QString ImageCache::bioTypeImagePath(int biotype)
+{
+    switch(biotype) {
+    case BIOTYPE_FINGERPRINT:
+        return IMAGE_DIR "FingerPrint.png";
+    case BIOTYPE_FINGERVEIN:
+        return IMAGE_DIR "FingerVein.png";
+    case BIOTYPE_IRIS:
+        return IMAGE_DIR "Iris.png";
+    case BIOTYPE_VOICEPRINT:
+        return IMAGE_DIR "VoicePrint.png";
+    }
+    return QString();
+}
+
+QString ImageCache::progressFramePath(int frame)
+{
+    return QString(IMAGE_DIR "huawei/%1.svg").arg(frame, 2, 10, QChar('0'));
+}
+
+/**
+ * @brief 获取图片，缓存中没有时按当前设备像素比解码
+ */
+QPixmap ImageCache::pixmap(const QString &fileName)
+{
+    if(fileName.isEmpty())
+        return QPixmap();
+
+    qreal ratio = qApp->devicePixelRatio();
+    QString key = QString("biometric:%1@%2").arg(fileName).arg(ratio);
+    QPixmap pixmap;
+    if(QPixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    pixmap = load(fileName, ratio);
+    if(!pixmap.isNull())
+        QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+QPixmap ImageCache::bioTypeImage(int biotype)
+{
+    return pixmap(bioTypeImagePath(biotype));
+}
+
+/**
+ * @brief 录入进度对应的帧
+ * @param percent 0 ~ 100
+ */
+QPixmap ImageCache::progressFrame(int percent)
+{
+    int frame = qBound(0, percent * (PROGRESS_FRAME_COUNT - 1) / 100, PROGRESS_FRAME_COUNT - 1);
+    return pixmap(progressFramePath(frame));
+}
+
+/**
+ * @brief 获取解码后的动画，第一次使用时解码全部帧
+ */
+AnimationPtr ImageCache::animation(const QString &fileName)
+{
+    auto iter = animations.constFind(fileName);
+    if(iter != animations.constEnd())
+        return iter.value();
+
+    AnimationPtr frames = loadAnimation(fileName);
+    if(frames)
+        animations.insert(fileName, frames);
+    return frames;
+}
+
+/**
+ * @brief 空闲时逐个解码全部图片，每轮事件循环只处理一个，不阻塞界面
+ */
+void ImageCache::warmUp()
+{
+    if(warming)
+        return;
+
+    warmQueue.clear();
+    for(int biotype : {BIOTYPE_FINGERPRINT, BIOTYPE_FINGERVEIN,
+                       BIOTYPE_IRIS, BIOTYPE_VOICEPRINT})
+        warmQueue.append(bioTypeImagePath(biotype));
+    for(int frame = 0; frame < PROGRESS_FRAME_COUNT; frame++)
+        warmQueue.append(progressFramePath(frame));
+    for(const QString &gif : {":/images/assets/fingerprint.gif", ":/images/assets/fingervein.gif",
+                              ":/images/assets/iris.gif", ":/images/assets/voiceprint.gif"})
+        warmQueue.append(gif);
+
+    warming = true;
+    QTimer::singleShot(0, this, &ImageCache::warmNext);
+}
+
+void ImageCache::warmNext()
+{
+    if(warmQueue.isEmpty()) {
+        warming = false;
+        return;
+    }
+
+    QString fileName = warmQueue.takeFirst();
+    if(fileName.endsWith(".gif", Qt::CaseInsensitive))
+        animation(fileName);
+    else
+        pixmap(fileName);
+    QTimer::singleShot(0, this, &ImageCache::warmNext);
+}
+
+/**
+ * @brief 解码图片，矢量图按设备像素比放大后栅格化，保证高分屏上清晰
+ */
+QPixmap ImageCache::load(const QString &fileName, qreal ratio)
+{
+    QImageReader reader(fileName);
+    QSize size = reader.size();
+    if(size.isValid() && ratio != 1.0 && fileName.endsWith(".svg", Qt::CaseInsensitive))
+        reader.setScaledSize(size * ratio);
+
+    QImage image = reader.read();
+    if(image.isNull()) {
+        qDebug() << "load image" << fileName << "failed:" << reader.errorString();
+        return QPixmap();
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    if(reader.scaledSize().isValid())
+        pixmap.setDevicePixelRatio(ratio);
+    return pixmap;
+}
+
+AnimationPtr ImageCache::loadAnimation(const QString &fileName)
+{
+    QImageReader reader(fileName);
+    QSharedPointer<AnimationFrames> frames(new AnimationFrames);
+
+    while(reader.canRead()) {
+        QImage image = reader.read();
+        if(image.isNull())
+            break;
+        int delay = reader.nextImageDelay();
+        frames->frames.append(QPixmap::fromImage(image));
+        frames->delays.append(delay > 0 ? delay : DEFAULT_FRAME_DELAY);
+        if(!reader.supportsAnimation())
+            break;
+    }
+
+    if(frames->frames.isEmpty()) {
+        qDebug() << "load animation" << fileName << "failed:" << reader.errorString();
+        return AnimationPtr();
+    }
+    return frames;
+}
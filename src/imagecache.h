@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ * 
+**/
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QObject>
+#include <QPixmap>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSharedPointer>
+
+#define PROGRESS_FRAME_COUNT    16      /* huawei/00.svg ~ huawei/15.svg */
+
+/**
+ * @brief 解码后的动画，所有对话框共用，只读
+ */
+struct AnimationFrames {
+    QVector<QPixmap> frames;
+    QVector<int> delays;    //每帧显示的时间，毫秒
+};
+typedef QSharedPointer<const AnimationFrames> AnimationPtr;
+
+/**
+ * @brief 提示对话框使用的图片缓存
+ *
+ * 图片按当前的设备像素比解码后放入 QPixmapCache，所有对话框共用；
+ * 录入进度的 SVG 帧只解析一次，之后的进度更新不再读盘。
+ * 各生物特征类型的 GIF 动画也只解码一次，解码后的帧一直保留。
+ * warmUp 在空闲时逐个预先解码。
+ */
+class ImageCache : public QObject
+{
+    Q_OBJECT
+private:
+    explicit ImageCache(QObject *parent = nullptr);
+    ImageCache(const ImageCache &cache) = delete;
+    ImageCache& operator =(const ImageCache &rhs) = delete;
+
+public:
+    static ImageCache *instance();
+    QPixmap pixmap(const QString &fileName);
+    QPixmap bioTypeImage(int biotype);
+    QPixmap progressFrame(int percent);
+    AnimationPtr animation(const QString &fileName);
+    void warmUp();
+
+    static QString bioTypeImagePath(int biotype);
+    static QString progressFramePath(int frame);
+
+private:
+    void warmNext();
+    static QPixmap load(const QString &fileName, qreal ratio);
+    static AnimationPtr loadAnimation(const QString &fileName);
+
+private:
+    static ImageCache *instance_;
+    QHash<QString, AnimationPtr> animations;
+    QStringList warmQueue;
+    bool warming;
+};
+
+#endif // IMAGECACHE_H
@@ -17,8 +17,8 @@
 **/
 #include "inputdialog.h"
 #include "ui_inputdialog.h"
-#include <QFile>
 #include "xatom-helper.h"
+#include "dialogpool.h"
 
 InputDialog::InputDialog(QWidget *parent) :
     QDialog(parent),
@@ -26,11 +26,7 @@ InputDialog::InputDialog(QWidget *parent) :
 {
     ui->setupUi(this);
     setWindowFlags(/*Qt::FramelessWindowHint |*/ Qt::Window);
-    QFile qssFile(":/css/assets/promptdialog.qss");
-    qssFile.open(QFile::ReadOnly);
-    QString styleSheet = QLatin1String(qssFile.readAll());
-    this->setStyleSheet(styleSheet);
-    qssFile.close();
+    this->setStyleSheet(DialogPool::styleSheet());
 
     //ui->btnClose->setIcon(QIcon(":/images/assets/close.png"));
     ui->btnClose->setProperty("isWindowButton", 0x2);
@@ -55,6 +51,19 @@ InputDialog::~InputDialog()
     delete ui;
 }
 
+/**
+ * @brief 清除上一次使用留下的内容和信号连接，供 DialogPool 复用
+ */
+void InputDialog::reset()
+{
+    disconnect(this, &InputDialog::dataChanged, nullptr, nullptr);
+    setTitle(QString());
+    ui->lblPrompt->clear();
+    ui->lblError->clear();
+    ui->lineEdit->clear();
+    ui->lineEdit->setFocus();
+}
+
 void InputDialog::setTitle(const QString &text)
 {
     ui->lblTitle->setText(text);
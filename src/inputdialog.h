@@ -32,6 +32,7 @@ public:
     explicit InputDialog(QWidget *parent = 0);
     ~InputDialog();
 
+    void reset();
     void setTitle(const QString &text);
     void setPrompt(const QString &text);
     void setError(const QString &text);
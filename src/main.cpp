@@ -132,6 +132,13 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
     }
 
+    /*
+     * 服务检查只依赖 DBus，最先发出；翻译加载、主窗口构建和设备列表、
+     * 认证状态的查询与之并行进行，检查失败时再提示并退出
+     */
+    ServiceManager *sm = ServiceManager::instance();
+    sm->checkService();
+
 	/* 对中文环境安装翻译 */
 	QString locale = QLocale::system().name();
 	QTranslator translator;
@@ -144,26 +151,6 @@ int main(int argc, char *argv[])
 	QMap<QString, QString> argMap;
 	parseArguments(a, argMap);
 
-    ServiceManager *sm = ServiceManager::instance();
-
-    if(!sm->serviceExists())
-    {
-        MessageDialog msgDialog(MessageDialog::Error,
-                                QObject::tr("Fatal Error"),
-                                QObject::tr("the biometric-authentication service was not started"));
-        msgDialog.exec();
-        exit(EXIT_FAILURE);
-    }
-
-    if(!sm->apiCompatible())
-    {
-        MessageDialog msgDialog(MessageDialog::Error,
-                                QObject::tr("Fatal Error"),
-                                QObject::tr("API version is not compatible"));
-        msgDialog.exec();
-        exit(EXIT_FAILURE);
-    }
-    
     MainWindow w(argMap.value("username"));
     w.setObjectName("MainWindow");
     MotifWmHints hints;
@@ -177,5 +164,21 @@ int main(int argc, char *argv[])
     QObject::connect(sm, &ServiceManager::serviceStatusChanged,
                      &w, &MainWindow::onServiceStatusChanged);
 
+    QObject::connect(sm, &ServiceManager::serviceChecked,
+                     &w, [&w](ServiceManager::CheckResult result) {
+        if(result == ServiceManager::ServiceReady)
+            return;
+
+        QString message = (result == ServiceManager::ServiceNotStarted)
+                ? QObject::tr("the biometric-authentication service was not started")
+                : QObject::tr("API version is not compatible");
+        w.hide();
+        MessageDialog msgDialog(MessageDialog::Error,
+                                QObject::tr("Fatal Error"),
+                                message);
+        msgDialog.exec();
+        exit(EXIT_FAILURE);
+    });
+
 	return a.exec();
 }
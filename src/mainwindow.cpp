@@ -19,15 +19,15 @@
 #include "ui_mainwindow.h"
 #include <QDBusArgument>
 #include <QFile>
-#include <QProcessEnvironment>
 #include <QScrollBar>
 #include <QMessageBox>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QMenu>
 #include <QDBusInterface>
-#include <QCheckBox>
 #include <QSettings>
+#include <QTimer>
+#include <QSet>
 #include <unistd.h>
 #include <pwd.h>
 #include "contentpane.h"
@@ -35,6 +35,18 @@
 #include "messagedialog.h"
 #include "aboutdialog.h"
 #include "configuration.h"
+#include "biometricproxy.h"
+#include "servicemanager.h"
+#include "deviceregistry.h"
+#include "devicetablemodel.h"
+#include "devicetabledelegate.h"
+#include "devicelistmodel.h"
+#include "bioauthstatus.h"
+#include "imagecache.h"
+#include "dialogpool.h"
+
+/* 与 polkit 动作中的 exec.path 一致 */
+#define DRIVERS_APPLY_PATH      "/usr/lib/biometric-manager/biometric-drivers-apply"
 
 
 #define ICON_SIZE 32
@@ -42,10 +54,13 @@
 MainWindow::MainWindow(QString usernameFromCmd, QWidget *parent) :
 	QMainWindow(parent),
 	ui(new Ui::MainWindow),
+    deviceListModel(nullptr),
+    deviceTableModel(nullptr),
+    hotPlugScheduled(false),
     username(usernameFromCmd),
     verificationStatus(false),
     dragWindow(false),
-    lastDeviceInfo(nullptr),
+    lastDeviceId(-1),
     aboutDlg(nullptr)
 {
 	ui->setupUi(this);
@@ -215,34 +230,52 @@ void MainWindow::onReviceWindowMessage(QString message)
 
 void MainWindow::initialize()
 {
-	/* 向 QDBus 类型系统注册自定义数据类型 */
-	registerCustomTypes();
 	/* 连接 DBus Daemon */
-    serviceInterface = new QDBusInterface(DBUS_SERVICE, DBUS_PATH,
-                                          DBUS_INTERFACE,
-                                          QDBusConnection::systemBus());
-    serviceInterface->setTimeout(2147483647); /* 微秒 */
+    serviceInterface = BiometricProxy::instance();
+
+    deviceRegistry = new DeviceRegistry(this);
+    connect(deviceRegistry, &DeviceRegistry::deviceAdded, this, &MainWindow::addContentPane);
+    connect(deviceRegistry, &DeviceRegistry::deviceChanged, this, &MainWindow::updateContentPane);
+    connect(deviceRegistry, &DeviceRegistry::deviceRemoved, this, &MainWindow::removeContentPane);
+
+    initDeviceLists();
 
     initSysMenu();
 
     /* 获取并显示用户 */
     setCurrentUser();
 
-	/* 获取设备列表 */
-	getDeviceInfo();
-
-	/* Other initializations */
+	/* Other initializations, 认证状态和设备列表的查询同时进行 */
 	initDashboardBioAuthSection();
-	initBiometricPage();
     initDeviceTypeList();
+    initDeviceTable();
+
+	/* 获取设备列表 */
+    getDeviceInfo([this]{
+        initBiometricPage();
+    });
 
     connect(ui->btnMin, &QPushButton::clicked, this, &MainWindow::showMinimized);
     connect(ui->btnClose, &QPushButton::clicked, this, &MainWindow::close);
 
     ui->btnDashBoard->click();
 
-    connect(serviceInterface, SIGNAL(USBDeviceHotPlug(int, int, int)),
-            this, SLOT(onUSBDeviceHotPlug(int,int,int)));
+    connect(serviceInterface, &BiometricProxy::USBDeviceHotPlug,
+            this, &MainWindow::onUSBDeviceHotPlug);
+
+    /* 空闲时预先解码提示对话框使用的图片，主窗口显示后预先创建对话框 */
+    ImageCache::instance()->warmUp();
+    DialogPool::instance()->setParentWidget(this);
+    DialogPool::instance()->prewarm();
+
+    /* 默认设备在后台写入，写入失败时提示 */
+    connect(Configuration::instance(), &Configuration::saveFailed,
+            this, [this](const QString &fileName, const QString &errorString) {
+        PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(
+                    MessageDialog::Error, tr("Error"),
+                    tr("Fail to save the default device to %1: %2").arg(fileName).arg(errorString)));
+        msgDialog->exec();
+    });
 }
 
 void MainWindow::initSysMenu()
@@ -250,8 +283,7 @@ void MainWindow::initSysMenu()
     menu = new QMenu(this);
     QAction *serviceStatusAction = new QAction(tr("Restart Service"), this);
     connect(serviceStatusAction, &QAction::triggered, this, [&]{
-        if(restartService())
-            updateDevice();
+        restartService();
     });
 
     QAction *aboutAction = new QAction(tr("About"), this);
@@ -344,6 +376,7 @@ void MainWindow::on_btnFingerPrint_clicked()
     ui->stackedWidgetMain->setCurrentWidget(ui->pageFingerPrint);
 
     changeBtnColor(ui->btnFingerPrint);
+    prefetchCurrentPage();
 }
 
 void MainWindow::on_btnFingerVein_clicked()
@@ -351,6 +384,7 @@ void MainWindow::on_btnFingerVein_clicked()
     ui->stackedWidgetMain->setCurrentWidget(ui->pageFingerVein);
 
     changeBtnColor(ui->btnFingerVein);
+    prefetchCurrentPage();
 }
 
 void MainWindow::on_btnIris_clicked()
@@ -358,6 +392,7 @@ void MainWindow::on_btnIris_clicked()
     ui->stackedWidgetMain->setCurrentWidget(ui->pageIris);
 
     changeBtnColor(ui->btnIris);
+    prefetchCurrentPage();
 }
 
 void MainWindow::on_btnVoicePrint_clicked()
@@ -365,6 +400,19 @@ void MainWindow::on_btnVoicePrint_clicked()
     ui->stackedWidgetMain->setCurrentWidget(ui->pageVoicePrint);
 
     changeBtnColor(ui->btnVoicePrint);
+    prefetchCurrentPage();
+}
+
+/**
+ * @brief 索引到设备类型的映射
+ */
+int MainWindow::indexToBioType(int index)
+{
+    static const int bioTypes[] = {BIOTYPE_FINGERPRINT, BIOTYPE_FINGERVEIN,
+                                   BIOTYPE_IRIS, BIOTYPE_VOICEPRINT};
+    if(index < 0 || index >= int(sizeof(bioTypes) / sizeof(bioTypes[0])))
+        return -1;
+    return bioTypes[index];
 }
 
 /**
@@ -386,181 +434,168 @@ int MainWindow::bioTypeToIndex(int type)
 }
 
 /**
- * @brief 获取设备列表并存储起来备用
+ * @brief 获取设备列表并存储起来备用，完成后执行 callback
  */
-void MainWindow::getDeviceInfo()
+void MainWindow::getDeviceInfo(const std::function<void ()> &callback)
 {
-	QVariant variant;
-	QDBusArgument argument;
-	QList<QDBusVariant> qlist;
-	QDBusVariant item;
-	DeviceInfo *deviceInfo;
-
 	/* 返回值为 i -- int 和 av -- array of variant */
-    QDBusPendingReply<int, QList<QDBusVariant> > reply = serviceInterface->call("GetDrvList");
-	reply.waitForFinished();
-	if (reply.isError()) {
-		qDebug() << "GUI:" << reply.error();
-		deviceCount = 0;
-		return;
-	}
-
-	/* 解析 DBus 返回值，reply 有两个返回值，都是 QVariant 类型 */
-	variant = reply.argumentAt(0); /* 得到第一个返回值 */
-	deviceCount = variant.value<int>(); /* 解封装得到设备个数 */
-	variant = reply.argumentAt(1); /* 得到第二个返回值 */
-	argument = variant.value<QDBusArgument>(); /* 解封装，获取QDBusArgument对象 */
-	argument >> qlist; /* 使用运算符重载提取 argument 对象里面存储的列表对象 */
-
-    for(int i = 0; i < __MAX_NR_BIOTYPES; i++)
-        deviceInfosMap[i].clear();;
-
-	for (int i = 0; i < deviceCount; i++) {
-		item = qlist[i]; /* 取出一个元素 */
-		variant = item.variant(); /* 转为普通QVariant对象 */
-		/* 解封装得到 QDBusArgument 对象 */
-		argument = variant.value<QDBusArgument>();
-		deviceInfo = new DeviceInfo();
-		argument >> *deviceInfo; /* 提取最终的 DeviceInfo 结构体 */
+    watchReply(serviceInterface->GetDrvList(), this,
+               [this, callback](const QDBusPendingReply<int, QList<QDBusVariant> > &reply) {
+        if (reply.isError()) {
+            qDebug() << "GUI:" << reply.error();
+            deviceCount = 0;
+        } else {
+            setDeviceInfo(reply);
+        }
+        callback();
+    });
+}
 
-        deviceInfosMap[bioTypeToIndex(deviceInfo->biotype)].append(deviceInfo);
+void MainWindow::setDeviceInfo(const QDBusPendingReply<int, QList<QDBusVariant> > &reply)
+{
+	deviceCount = reply.argumentAt<0>(); /* 设备个数 */
+	/* 设备列表 */
+    QVector<DeviceInfo> deviceList = decodeVariantArray<DeviceInfo>(reply.reply(), 1, deviceCount);
 
-//        qDebug() << deviceInfo->biotype << deviceInfo->device_shortname << deviceInfo->device_available;
-	}
+    /* 合并到设备表中，只有变化的设备对应的页面、列表项和表格行会被更新 */
+    deviceRegistry->reconcile(deviceList);
 }
 
 void MainWindow::setLastDeviceSelected()
 {
-    if(!lastDeviceInfo)
-        return ;
+    int deviceId = lastDeviceId;
+    lastDeviceId = -1;
+    selectDevice(deviceId);
+}
 
-    QListWidget *lw;
+/**
+ * @brief 在设备所属的生物特征页面上选中该设备
+ */
+bool MainWindow::selectDevice(int deviceId)
+{
+    DeviceInfo *deviceInfo = deviceRegistry->device(deviceId);
+    QListView *lv;
     QStackedWidget *sw;
+    if(!deviceInfo || !getPageWidgets(deviceInfo->biotype, &lv, &sw))
+        return false;
 
-    switch(lastDeviceInfo->biotype) {
-    case BIOTYPE_FINGERPRINT:
-        lw = ui->listWidgetFingerPrint;
-        sw = ui->stackedWidgetFingerPrint;
-        break;
-    case BIOTYPE_FINGERVEIN:
-        lw = ui->listWidgetFingerVein;
-        sw = ui->stackedWidgetFingerVein;
-        break;
-    case BIOTYPE_IRIS:
-        lw = ui->listWidgetIris;
-        sw = ui->stackedWidgetIris;
-        break;
-    case BIOTYPE_VOICEPRINT:
-        lw = ui->listWidgetVoicePrint;
-        sw = ui->stackedWidgetVoicePrint;
-        break;
-    }
+    DeviceFilterModel *filterModel = qobject_cast<DeviceFilterModel*>(lv->model());
+    QModelIndex index = filterModel ? filterModel->indexOfDevice(deviceId) : QModelIndex();
+    if(!index.isValid())
+        return false;
+    lv->setCurrentIndex(index);
+    return true;
+}
 
-    for(int i=0;i<lw->count();i++)
-    {
-        if(lw->item(i)->text()==lastDeviceInfo->device_shortname)
-        {
-            lw->setCurrentRow(i);
-            sw->setCurrentIndex(i);
-        }
+/**
+ * @brief 每种生物特征的设备列表都是同一个设备模型的过滤、排序视图，
+ * 右侧显示的页面按选中设备的 id 查找
+ */
+void MainWindow::initDeviceLists()
+{
+    deviceListModel = new DeviceListModel(deviceRegistry, this);
+
+    for(int biotype : {BIOTYPE_FINGERPRINT, BIOTYPE_FINGERVEIN, BIOTYPE_IRIS, BIOTYPE_VOICEPRINT}) {
+        QListView *lv;
+        QStackedWidget *sw;
+        getPageWidgets(biotype, &lv, &sw);
+
+        DeviceFilterModel *filterModel = new DeviceFilterModel(biotype, this);
+        filterModel->setSourceModel(deviceListModel);
+        lv->setModel(filterModel);
+        lv->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+        connect(lv->selectionModel(), &QItemSelectionModel::currentChanged,
+                this, [this, sw](const QModelIndex &current) {
+            ContentPane *contentPane =
+                    contentPaneMap.value(current.data(DeviceListModel::DeviceIdRole).toInt());
+            if(contentPane)
+                sw->setCurrentWidget(contentPane);
+        });
     }
-
-    lastDeviceInfo = nullptr;
 }
 
-void MainWindow::raiseContentPane(DeviceInfo *deviceInfo)
+void MainWindow::addContentPane(DeviceInfo *deviceInfo)
 {
-    if(deviceInfo->device_available<=0)
-        return ;
-
-    QListWidget *lw;
-    QStackedWidget *sw;
+    QListView *lv;
+	QStackedWidget *sw;
+    if(!getPageWidgets(deviceInfo->biotype, &lv, &sw))
+        return;
 
-    switch(deviceInfo->biotype) {
-    case BIOTYPE_FINGERPRINT:
-        lw = ui->listWidgetFingerPrint;
-        sw = ui->stackedWidgetFingerPrint;
-        break;
-    case BIOTYPE_FINGERVEIN:
-        lw = ui->listWidgetFingerVein;
-        sw = ui->stackedWidgetFingerVein;
-        break;
-    case BIOTYPE_IRIS:
-        lw = ui->listWidgetIris;
-        sw = ui->stackedWidgetIris;
-        break;
-    case BIOTYPE_VOICEPRINT:
-        lw = ui->listWidgetVoicePrint;
-        sw = ui->stackedWidgetVoicePrint;
-        break;
-    }
+    ContentPane *contentPane = new ContentPane(getuid(), *deviceInfo);
+    sw->addWidget(contentPane);
+    contentPaneMap.insert(deviceInfo->device_id, contentPane);
 
-    for(int i=0;i<lw->count();i++)
-    {
-        if(lw->item(i)->text()==deviceInfo->device_shortname)
-        {
-            QListWidgetItem *item = lw->takeItem(i);
-            lw->insertItem(0,item);
-            QWidget *widget = sw->widget(i);
-            sw->removeWidget(sw->widget(i));
-            sw->insertWidget(0,widget);
+    connect(contentPane, &ContentPane::changeDeviceStatus, this, &MainWindow::changeDeviceStatus);
+    connect(contentPane, &ContentPane::featuresLoaded, this, [this, contentPane]{
+        if(prefetchPane == contentPane) {
+            prefetchPane = nullptr;
+            QTimer::singleShot(0, this, &MainWindow::prefetchNext);
         }
-    }
+    });
+}
 
+/**
+ * @brief 设备被删除（或生物特征类型改变）时移除对应的页面
+ */
+void MainWindow::removeContentPane(DeviceInfo *deviceInfo)
+{
+    if(lastDeviceId == deviceInfo->device_id)
+        lastDeviceId = -1;
+
+    ContentPane *contentPane = contentPaneMap.take(deviceInfo->device_id);
+    QListView *lv;
+    QStackedWidget *sw;
+    if(!contentPane || !getPageWidgets(deviceInfo->biotype, &lv, &sw))
+        return;
+
+    sw->removeWidget(contentPane);
+    contentPane->deleteLater();
 }
 
-void MainWindow::addContentPane(DeviceInfo *deviceInfo)
+/**
+ * @brief 设备信息变化时原地更新页面，页面中已加载的特征列表保留
+ */
+void MainWindow::updateContentPane(DeviceInfo *deviceInfo)
 {
-    QListWidget *lw;
-	QStackedWidget *sw;
+    ContentPane *contentPane = contentPaneMap.value(deviceInfo->device_id);
+    if(contentPane)
+        contentPane->setDeviceInfo(*deviceInfo);
+}
 
-    switch(deviceInfo->biotype) {
+bool MainWindow::getPageWidgets(int biotype, QListView **lv, QStackedWidget **sw)
+{
+    switch(biotype) {
     case BIOTYPE_FINGERPRINT:
-        lw = ui->listWidgetFingerPrint;
-        sw = ui->stackedWidgetFingerPrint;
-        break;
+        *lv = ui->listViewFingerPrint;
+        *sw = ui->stackedWidgetFingerPrint;
+        return true;
     case BIOTYPE_FINGERVEIN:
-        lw = ui->listWidgetFingerVein;
-        sw = ui->stackedWidgetFingerVein;
-        break;
+        *lv = ui->listViewFingerVein;
+        *sw = ui->stackedWidgetFingerVein;
+        return true;
     case BIOTYPE_IRIS:
-        lw = ui->listWidgetIris;
-        sw = ui->stackedWidgetIris;
-        break;
+        *lv = ui->listViewIris;
+        *sw = ui->stackedWidgetIris;
+        return true;
     case BIOTYPE_VOICEPRINT:
-        lw = ui->listWidgetVoicePrint;
-        sw = ui->stackedWidgetVoicePrint;
-        break;
-    }
-
-    QListWidgetItem *item = new QListWidgetItem(deviceInfo->device_shortname);
-    ContentPane *contentPane = new ContentPane(getuid(), deviceInfo);
-	item->setTextAlignment(Qt::AlignCenter);
-    if(deviceInfo->device_available <= 0){
-        lw->insertItem(lw->count(), item);
-        sw->insertWidget(sw->count(),contentPane);
-    }
-    else {
-        lw->insertItem(0,item);
-        sw->insertWidget(0,contentPane);
+        *lv = ui->listViewVoicePrint;
+        *sw = ui->stackedWidgetVoicePrint;
+        return true;
     }
-    if(deviceInfo->device_available <= 0)
-        item->setTextColor(Qt::gray);
-
-    contentPaneMap.insert(deviceInfo->device_shortname, contentPane);
-
-    connect(lw, &QListWidget::currentRowChanged, sw, &QStackedWidget::setCurrentIndex);
-    connect(contentPane, &ContentPane::changeDeviceStatus, this, &MainWindow::changeDeviceStatus);
+    return false;
 }
 
 #define checkBiometricPage(biometric) do {				\
-	if (ui->listWidget##biometric->count() >= 1) {			\
-		ui->listWidget##biometric->setCurrentRow(0);		\
-		ui->listWidget##biometric->show();			\
+	QAbstractItemModel *model = ui->listView##biometric->model();	\
+	if (model->rowCount() >= 1) {					\
+		if (!ui->listView##biometric->currentIndex().isValid())	\
+			ui->listView##biometric->setCurrentIndex(model->index(0, 0)); \
+		ui->listView##biometric->show();			\
 		ui->stackedWidget##biometric->show();			\
 		ui->lblNoDevice##biometric->hide();			\
 	} else {							\
-		ui->listWidget##biometric->hide();			\
+		ui->listView##biometric->hide();			\
 		ui->stackedWidget##biometric->hide();			\
 		ui->lblNoDevice##biometric->show();			\
 	}								\
@@ -568,59 +603,68 @@ void MainWindow::addContentPane(DeviceInfo *deviceInfo)
 
 void MainWindow::initBiometricPage()
 {
-    ui->listWidgetFingerPrint->clear();
-    for(int i = ui->stackedWidgetFingerPrint->count(); i >= 0; i--)
-    {
-        QWidget* widget = ui->stackedWidgetFingerPrint->widget(i);
-        ui->stackedWidgetFingerPrint->removeWidget(widget);
-        widget->deleteLater();
-    }
-    ui->listWidgetFingerVein->clear();
-    for(int i = ui->stackedWidgetFingerVein->count(); i >= 0; i--)
-    {
-        QWidget* widget = ui->stackedWidgetFingerVein->widget(i);
-        ui->stackedWidgetFingerVein->removeWidget(widget);
-        widget->deleteLater();
-    }
-    ui->listWidgetIris->clear();
-    for(int i = ui->stackedWidgetIris->count(); i >= 0; i--)
-    {
-        QWidget* widget = ui->stackedWidgetIris->widget(i);
-        ui->stackedWidgetIris->removeWidget(widget);
-        widget->deleteLater();
-    }
-    ui->listWidgetVoicePrint->clear();
-    for(int i = ui->stackedWidgetVoicePrint->count(); i >= 0; i--)
-    {
-        QWidget* widget = ui->stackedWidgetVoicePrint->widget(i);
-        ui->stackedWidgetVoicePrint->removeWidget(widget);
-        widget->deleteLater();
+    updateBiometricPage();
+    prefetchCurrentPage();
+}
+
+/**
+ * @brief 预取当前显示的生物特征页面上的设备
+ *
+ * 只有打开过的页面才会查询特征列表，正在显示的设备由 ContentPane 自己查询，
+ * 同一页面上的其它设备在空闲时逐个查询，不会同时发出所有请求。
+ */
+void MainWindow::prefetchCurrentPage()
+{
+    QWidget *page = ui->stackedWidgetMain->currentWidget();
+    if(page == ui->pageFingerPrint)
+        prefetchFeatures(ui->listViewFingerPrint);
+    else if(page == ui->pageFingerVein)
+        prefetchFeatures(ui->listViewFingerVein);
+    else if(page == ui->pageIris)
+        prefetchFeatures(ui->listViewIris);
+    else if(page == ui->pageVoicePrint)
+        prefetchFeatures(ui->listViewVoicePrint);
+}
+
+void MainWindow::prefetchFeatures(QListView *lv)
+{
+    /* 只预取当前页面，按列表中显示的顺序；离开的页面再打开时会重新加入 */
+    prefetchQueue.clear();
+    QAbstractItemModel *model = lv->model();
+    for(int row = 0; row < model->rowCount(); row++) {
+        int deviceId = model->index(row, 0).data(DeviceListModel::DeviceIdRole).toInt();
+        ContentPane *pane = contentPaneMap.value(deviceId);
+        if(pane)
+            prefetchQueue.append(pane);
     }
-    contentPaneMap.clear();
+    if(!prefetchPane)
+        QTimer::singleShot(0, this, &MainWindow::prefetchNext);
+}
 
-    for(int i = 0; i < __MAX_NR_BIOTYPES; i++){
-        for (auto deviceInfo : deviceInfosMap[i]){
-            ContentPane *contentPane = contentPaneMap[deviceInfo->device_shortname];
-            addContentPane(deviceInfo);
+void MainWindow::prefetchNext()
+{
+    if(prefetchPane)
+        return;
+    while(!prefetchQueue.isEmpty()) {
+        QPointer<ContentPane> pane = prefetchQueue.takeFirst();
+        if(pane && pane->prefetchFeatures()) {
+            prefetchPane = pane;
+            return;
         }
     }
-    checkBiometricPage(FingerPrint);
-    checkBiometricPage(FingerVein);
-	checkBiometricPage(Iris);
-    checkBiometricPage(VoicePrint);
 }
 
-void MainWindow::sortContentPane()
+/**
+ * @brief 根据设备数量显示设备列表或“未找到驱动”的提示，设备的顺序由 DeviceFilterModel 维护
+ */
+void MainWindow::updateBiometricPage()
 {
-    for(int i = 0; i < __MAX_NR_BIOTYPES; i++)
-        for (auto deviceInfo : deviceInfosMap[i])
-            raiseContentPane(deviceInfo);
     checkBiometricPage(FingerPrint);
     checkBiometricPage(FingerVein);
     checkBiometricPage(Iris);
     checkBiometricPage(VoicePrint);
 
-    if(lastDeviceInfo)
+    if(lastDeviceId >= 0)
         setLastDeviceSelected();
 }
 
@@ -639,17 +683,52 @@ void MainWindow::sortContentPane()
 
 void MainWindow::initDashboardBioAuthSection()
 {
-	QProcess process;
-	process.start("bioctl status");
-	process.waitForFinished();
-	QString output = process.readAllStandardOutput();
-    qDebug() << "bioctl status ---" << output;
-    if (output.contains("enable", Qt::CaseInsensitive)) {
-        setVerificationStatus(true);
-    }
-    else {
-        setVerificationStatus(false);
+    /* 直接读取开关配置，配置在程序外被修改时同步更新 */
+    BioAuthStatus *bioAuthStatus = BioAuthStatus::instance();
+    connect(bioAuthStatus, &BioAuthStatus::enableChanged,
+            this, &MainWindow::setVerificationStatus);
+    if(bioAuthStatus->isAvailable()) {
+        setVerificationStatus(bioAuthStatus->isEnabled());
+        return;
     }
+
+    /* 读不到配置文件时退回到 bioctl status，结果返回前先显示空白状态，并禁止切换 */
+    ui->lblStatus->clear();
+    ui->lblNote->clear();
+    ui->btnStatus->setEnabled(false);
+
+    CommandRunner::run("bioctl", {"status"}, this, [this](const CommandResult &result) {
+        QString output = result.standardOutput;
+        qDebug() << "bioctl status ---" << (result.failedToStart ? result.errorString : output);
+        setVerificationStatus(result.success() && output.contains("enable", Qt::CaseInsensitive));
+        ui->btnStatus->setEnabled(true);
+    });
+}
+
+void MainWindow::initDeviceTable()
+{
+    deviceTableModel = new DeviceTableModel(deviceRegistry, this);
+    deviceTableModel->setBiotype(indexToBioType(ui->listWidgetDevicesType->currentRow()));
+
+    /* 表格中的驱动开关只记录修改，点击“应用”后一次完成 */
+    DeviceTableDelegate *delegate = new DeviceTableDelegate(this);
+    connect(delegate, &DeviceTableDelegate::driverSwitchClicked,
+            deviceTableModel, &DeviceTableModel::togglePendingDriver);
+    connect(deviceTableModel, &DeviceTableModel::pendingDriversChanged,
+            this, &MainWindow::updateDriverChangesBar);
+    updateDriverChangesBar(0);
+
+    ui->tableViewDevices->setModel(deviceTableModel);
+    ui->tableViewDevices->setItemDelegate(delegate);
+    ui->tableViewDevices->setFocusPolicy(Qt::NoFocus);
+    ui->tableViewDevices->setColumnWidth(0, 100);
+    ui->tableViewDevices->setColumnWidth(1, 100);
+    ui->tableViewDevices->setColumnWidth(2, 100);
+    ui->tableViewDevices->setColumnWidth(3, 80);
+    ui->tableViewDevices->setColumnWidth(4, 100);
+    ui->tableViewDevices->setColumnWidth(5, 100);
+    ui->tableViewDevices->setColumnWidth(6, 100);
+    ui->tableViewDevices->setColumnWidth(7, 50);
 }
 
 void MainWindow::initDeviceTypeList()
@@ -689,200 +768,39 @@ void MainWindow::setVerificationStatus(bool status)
 
 void MainWindow::on_btnStatus_clicked()
 {
-    QProcess process;
-    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
-    if (verificationStatus) {
-        process.start("bioctl disable");
-        process.waitForFinished(-1);
-        if (process.exitCode() == 0)
-            setVerificationStatus(false);
-    } else {
-        process.start("bioctl enable");
-        process.waitForFinished(-1);
-        if (process.exitCode() == 0)
-            setVerificationStatus(true);
-    }
-}
-
-void MainWindow::on_listWidgetDevicesType_currentRowChanged(int currentRow)
-{
-    int deviceType = (currentRow);
-    QStringList headerData;
-    headerData << "    " + tr("Device Name") << tr("Device Status") << tr("Driver Status") << tr("Default")
-               << "    " + tr("Device Name") << tr("Device Status") << tr("Driver Status") << tr("Default");
-    ui->tableWidgetDevices->hide();
-    ui->tableWidgetDevices->clear();
-    ui->tableWidgetDevices->setRowCount(0);
-    ui->tableWidgetDevices->setColumnCount(8);
-    ui->tableWidgetDevices->setHorizontalHeaderLabels(headerData);
-    ui->tableWidgetDevices->setFocusPolicy(Qt::NoFocus);
-    for(int i = 0; i < headerData.size(); i++){
-        if(i % 4 == 0)
-            ui->tableWidgetDevices->horizontalHeaderItem(i)->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    bool toEnable = !verificationStatus;
+
+    /* 命令返回前禁止再次切换 */
+    ui->btnStatus->setEnabled(false);
+    CommandRunner::run("bioctl", {toEnable ? "enable" : "disable"}, this,
+                       [this, toEnable](const CommandResult &result) {
+        if(result.success())
+            setVerificationStatus(toEnable);
         else
-            ui->tableWidgetDevices->horizontalHeaderItem(i)->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-    }
-    ui->tableWidgetDevices->setColumnWidth(0, 100);
-    ui->tableWidgetDevices->setColumnWidth(1, 100);
-    ui->tableWidgetDevices->setColumnWidth(2, 100);
-    ui->tableWidgetDevices->setColumnWidth(3, 80);
-    ui->tableWidgetDevices->setColumnWidth(4, 100);
-    ui->tableWidgetDevices->setColumnWidth(5, 100);
-    ui->tableWidgetDevices->setColumnWidth(6, 100);
-    ui->tableWidgetDevices->setColumnWidth(7, 50);
-    int column = 0;
-    
-    while(!btnGroup.isEmpty())
-    {
-           QCheckBox *box = btnGroup.last();
-           btnGroup.removeLast();
-           delete  box;
-    }
-    
-    for(int i=0;i<deviceInfosMap[deviceType].count();i++)
-    {
-        if(deviceInfosMap[deviceType].at(i)->device_available > 0)
-        {
-            deviceInfosMap[deviceType].move(i,0);
-        }
-    } 
-    for(auto deviceInfo : deviceInfosMap[deviceType]) {
-        if(bioTypeToIndex(deviceInfo->biotype) == deviceType) {
-            int row_index = ui->tableWidgetDevices->rowCount();
-            if(column == 0)
-                ui->tableWidgetDevices->insertRow(row_index);
-            else
-                row_index--;
-
-            //第一、五列 设备名称
-            QTableWidgetItem *item_name = new QTableWidgetItem("   " + deviceInfo->device_shortname);
-            item_name->setFlags(item_name->flags() ^ Qt::ItemIsEditable);
-            ui->tableWidgetDevices->setItem(row_index, column, item_name);
-
-            //第二、六列 设备状态（是否连接）
-            QTableWidgetItem *item_devStatus = new QTableWidgetItem;
-            setDeviceStatus(item_devStatus, deviceInfo->device_available > 0);
-            item_devStatus->setFlags(item_name->flags() ^ Qt::ItemIsEditable);
-            item_devStatus->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-            ui->tableWidgetDevices->setItem(row_index, column + 1, item_devStatus);
-
-            //第三、七列 驱动状态（是否使能）
-            QWidget *item_drvStatus = new QWidget();
-            QPushButton *btnDrvStatus = new QPushButton(this);
-            btnDrvStatus->setObjectName(deviceInfo->device_shortname + "_" + QString::number(deviceType));
-            btnDrvStatus->setFixedSize(40, 20);
-            if(deviceInfo->driver_enable > 0)
-                btnDrvStatus->setStyleSheet("background:url(:/images/assets/switch_open_small.png);text-align:center;border: none;outline: none;background-repeat:no-repeat;");
-            else
-                btnDrvStatus->setStyleSheet("background:url(:/images/assets/switch_close_small.png);text-align:center;border: none;outline: none;background-repeat:no-repeat;");
-            connect(btnDrvStatus, &QPushButton::clicked, this, &MainWindow::onDriverStatusClicked);
-
-            QVBoxLayout *layout = new QVBoxLayout(item_drvStatus);
-            layout->addWidget(btnDrvStatus, 0, Qt::AlignVCenter | Qt::AlignHCenter);
-            layout->setMargin(0);
-            item_drvStatus->setLayout(layout);
-            ui->tableWidgetDevices->setCellWidget(row_index, column + 2, item_drvStatus);
-
-            //第四、八列 默认设备（是否设为默认设备）
-            QWidget *item_default = new QWidget(ui->tableWidgetDevices);
-            item_default->setObjectName("itemDefalut");
-            if(column == 0)
-                item_default->setStyleSheet("#itemDefalut{border-right: 1px solid lightgray; }");
-            QCheckBox *cbDefault = new QCheckBox(this);
-
-            if(Configuration::instance()->getDefaultDevice() == deviceInfo->device_shortname)
-                cbDefault->setChecked(true);
-            btnGroup.push_back(cbDefault);
-            cbDefault->setObjectName(deviceInfo->device_shortname);
-            connect(cbDefault, &QCheckBox::clicked, this, &MainWindow::onDefaultDeviceChanged);
-            connect(Configuration::instance(), &Configuration::defaultDeviceChanged,
-                    this, [&](const QString &deviceName) {
-                for(auto btn : btnGroup)
-                    btn->setChecked(false);
-
-                QString objName = deviceName;
-                QCheckBox *check = findChild<QCheckBox*>(objName);
-                if(check) {
-                    check->setChecked(true);
-                }
-            });
-
-            QHBoxLayout *layout_default = new QHBoxLayout;
-            layout_default->addWidget(cbDefault);
-            layout_default->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-            item_default->setLayout(layout_default);
-            ui->tableWidgetDevices->setCellWidget(row_index, column + 3, item_default);
-
-            column = (column + 4) % 8;
-        }
-    }
-    ui->tableWidgetDevices->show();
-}
-
-void MainWindow::onDriverStatusClicked()
-{
-    QString objNameStr = sender()->objectName();
-    qDebug() << objNameStr;
-    int spliter = objNameStr.lastIndexOf('_');
-    QString deviceName = objNameStr.left(spliter);
-    int deviceType = objNameStr.right(objNameStr.length() - spliter - 1).toInt();
-
-    if(deviceType != ui->listWidgetDevicesType->currentRow())
-        return;
-    DeviceInfo *deviceInfo;
-    for(auto info : deviceInfosMap[deviceType]) {
-        if(info->device_shortname == deviceName) {
-            deviceInfo = info;
-            break;
-        }
-    }
-
-    changeDeviceStatus(deviceInfo);
+            qDebug() << "bioctl" << (toEnable ? "enable" : "disable") << "failed:"
+                     << result.errorString << result.standardError;
+        ui->btnStatus->setEnabled(true);
+    }, PRIVILEGED_COMMAND_TIMEOUT);
 }
 
-void MainWindow::onDefaultDeviceChanged(bool checked)
+void MainWindow::on_listWidgetDevicesType_currentRowChanged(int currentRow)
 {
-    QString objName = sender()->objectName();
-    QString deviceName = objName;
-
-    for(auto cb : btnGroup)
-        if(cb != sender())
-            cb->setChecked(false);
-
-    if(checked)
-        Configuration::instance()->setDefaultDevice(deviceName);
-    else
-        Configuration::instance()->setDefaultDevice("");
+    if(deviceTableModel)
+        deviceTableModel->setBiotype(indexToBioType(currentRow));
 }
 
-
-bool MainWindow::changeDeviceStatus(DeviceInfo *deviceInfo)
+void MainWindow::changeDeviceStatus(DeviceInfo *deviceInfo)
 {
     bool toEnable = deviceInfo->driver_enable <= 0 ? true : false;
-    QProcess process;
-    QString cmd;
-    if (toEnable) {
-        qDebug() << "enable" << deviceInfo->device_shortname;
-        cmd = "pkexec biodrvctl enable " //"pkexec biometric-config-tool enable-driver "
-                + deviceInfo->device_shortname;
-        qDebug() << cmd;
-        process.start(cmd);
-        process.waitForFinished(-1);
-    } else {
-        qDebug() << "disable" << deviceInfo->device_shortname;
-        cmd = "pkexec biodrvctl disable " //"pkexec biometric-config-tool disable-driver "
-                + deviceInfo->device_shortname;
-        qDebug() << cmd;
-        process.start(cmd);
-        process.waitForFinished(-1);
-    }
-    if (process.exitCode() != 0) {
-        MessageDialog msgDialog(MessageDialog::Error,
-                            tr("Fatal Error"),
-                            tr("Fail to change device status"),this);
-        msgDialog.exec();
-        return false;
-    }
+    int deviceId = deviceInfo->device_id;
+    QHash<int, bool> changes;
+    changes.insert(deviceId, toEnable);
+
+    lastDeviceId = deviceId;
+    applyDriverChanges(changes, [this, deviceId](const QHash<int, bool> &results) {
+        if(!results.value(deviceId) && lastDeviceId == deviceId)
+            lastDeviceId = -1;
+    });
 //    MessageDialog msgDialog(MessageDialog::Question,
 //                            tr("Restart Service"),
 //                            tr("The configuration has been modified. "
@@ -896,8 +814,6 @@ bool MainWindow::changeDeviceStatus(DeviceInfo *deviceInfo)
 //        if(!restartService())
 //            return false;
 //    }
-    lastDeviceInfo = deviceInfo;
-    updateDevice();
 
     /*
      * There is a condition that the driver is enabled while the device is
@@ -931,11 +847,139 @@ bool MainWindow::changeDeviceStatus(DeviceInfo *deviceInfo)
 //    } else {
 //        deviceInfo->device_available = 0;
 //    }
+}
+
+/**
+ * @brief 应用驱动状态的修改
+ * @param changes device_id -> 修改后的驱动状态
+ * @param callback 结束后调用，参数为 device_id -> 是否修改成功
+ * 所有修改通过一次 pkexec 交给随包安装的 biometric-drivers-apply，只需要认证一次，不经过 shell；
+ * 它改完配置后只重启一次服务，这里也只等待服务、更新设备列表一次
+ */
+void MainWindow::applyDriverChanges(const QHash<int, bool> &changes,
+                                    const DriverChangesCallback &callback)
+{
+    QStringList arguments;
+    QHash<QString, bool> drivers;               //驱动名 -> 修改后的状态
+    QMultiHash<QString, int> driverDevices;     //驱动名 -> device_id，几个设备可能使用同一个驱动
+    QHash<int, bool> results;
+
+    arguments << DRIVERS_APPLY_PATH;
+    for(auto iter = changes.constBegin(); iter != changes.constEnd(); ++iter) {
+        DeviceInfo *deviceInfo = deviceRegistry->device(iter.key());
+        if(!deviceInfo)
+            continue;
+        const QString &name = deviceInfo->device_shortname;
+        if(!drivers.contains(name)) {
+            drivers.insert(name, iter.value());
+            arguments << (iter.value() ? "enable" : "disable") << name;
+        } else if(drivers.value(name) != iter.value()) {
+            /* 同一个驱动不能既启用又禁用 */
+            results.insert(iter.key(), false);
+            continue;
+        }
+        driverDevices.insert(name, iter.key());
+    }
+    if(driverDevices.isEmpty()) {
+        callback(results);
+        return;
+    }
+
+    /* 修改驱动后服务会重启，记下重启前的服务连接名 */
+    QString previousOwner = ServiceManager::instance()->serviceOwner();
+    bool started = runPrivilegedCommand(arguments,
+                                        [this, driverDevices, results, previousOwner, callback]
+                                        (const CommandResult &result) {
+        if(!result.success())
+            qDebug() << "change device status failed:" << result.exitCode
+                     << result.errorString << result.standardError;
+
+        /* 每个驱动输出一行 "<驱动名> ok|failed"，取消认证或者没有权限时没有输出，都算失败 */
+        QSet<QString> succeeded;
+        for(const QByteArray &line : result.standardOutput.split('\n')) {
+            QList<QByteArray> fields = line.simplified().split(' ');
+            if(fields.size() == 2 && fields.at(1) == "ok")
+                succeeded.insert(QString::fromLocal8Bit(fields.at(0)));
+        }
+
+        QHash<int, bool> driverResults = results;
+        QStringList failures;
+        for(const QString &name : driverDevices.uniqueKeys()) {
+            bool ok = succeeded.contains(name);
+            for(int deviceId : driverDevices.values(name))
+                driverResults.insert(deviceId, ok);
+            if(!ok)
+                failures.append(name);
+        }
+
+        /* 有修改成功时服务已经重启，等待服务后重新获取设备列表，表格按实际状态更新 */
+        if(!succeeded.isEmpty())
+            updateDevice(previousOwner);
+        callback(driverResults);
+
+        if(!failures.isEmpty()) {
+            PooledDialog<MessageDialog> msgDialog(DialogPool::instance()->acquireMessageDialog(
+                        MessageDialog::Error, tr("Fatal Error"), tr("Fail to change device status")));
+            msgDialog->setMessageList(failures);
+            msgDialog->exec();
+        }
+    });
+    if(!started)
+        callback(QHash<int, bool>());
+}
+
+/**
+ * @brief 异步执行 pkexec 提权命令
+ * 同一时间只允许一个提权命令，避免连续弹出多个认证对话框；命令返回前界面不阻塞
+ * @return 已有提权命令在执行时返回 false
+ */
+bool MainWindow::runPrivilegedCommand(const QStringList &arguments,
+                                      const CommandRunner::Callback &callback)
+{
+    if(privilegedCommand) {
+        qDebug() << "another privileged command is running:" << privilegedCommand->commandLine();
+        return false;
+    }
+
+    privilegedCommand = CommandRunner::run("pkexec", arguments, this,
+                                           [this, callback](const CommandResult &result) {
+        privilegedCommand = nullptr;
+        setCursor(Qt::ArrowCursor);
+        ui->btnApplyDriverChanges->setEnabled(true);
+        callback(result);
+    }, PRIVILEGED_COMMAND_TIMEOUT);
 
+    setCursor(Qt::BusyCursor);
+    ui->btnApplyDriverChanges->setEnabled(false);
     return true;
 }
 
-bool MainWindow::restartService()
+void MainWindow::updateDriverChangesBar(int count)
+{
+    ui->lblDriverChanges->setText(tr("%1 driver change(s) to apply").arg(count));
+    ui->lblDriverChanges->setVisible(count > 0);
+    ui->btnApplyDriverChanges->setVisible(count > 0);
+    ui->btnDiscardDriverChanges->setVisible(count > 0);
+}
+
+void MainWindow::on_btnApplyDriverChanges_clicked()
+{
+    /* 修改失败的驱动保留在待应用列表中，可以重试或者放弃 */
+    applyDriverChanges(deviceTableModel->pendingDrivers(), [this](const QHash<int, bool> &results) {
+        QList<int> applied;
+        for(auto iter = results.constBegin(); iter != results.constEnd(); ++iter)
+            if(iter.value())
+                applied.append(iter.key());
+        deviceTableModel->removePendingDrivers(applied);
+    });
+}
+
+void MainWindow::on_btnDiscardDriverChanges_clicked()
+{
+    deviceTableModel->clearPendingDrivers();
+}
+
+void MainWindow::restartService()
 {
 //    QDBusInterface interface("org.freedesktop.systemd1",
 //                             "/org/freedesktop/systemd1",
@@ -946,155 +990,97 @@ bool MainWindow::restartService()
 //        qDebug() << "restart service: " << msg.error();
 //        return false;
 //    }
-    QProcess process;
-    QString cmd = QString("pkexec biorestart");
-    process.start(cmd);
-    process.waitForFinished(-1);
-    qDebug() << "restart service finished";
-    return true;
+    QString previousOwner = ServiceManager::instance()->serviceOwner();
+    runPrivilegedCommand({"biorestart"}, [this, previousOwner](const CommandResult &result) {
+        qDebug() << "restart service finished, exit code:" << result.exitCode;
+        /* 取消认证或者失败时服务没有重启，不需要等待服务 */
+        if(result.success())
+            updateDevice(previousOwner);
+    });
+}
+
+/*!
+ * \brief MainWindow::updateDevice
+ * \param previousOwner 操作之前服务的连接名，为空时只要服务应答即可
+ * 等待服务重启完成、DBus 可以应答后再重新获取设备列表，不阻塞界面
+ */
+void MainWindow::updateDevice(const QString &previousOwner)
+{
+    setCursor(Qt::WaitCursor);
+    ServiceManager::instance()->waitForService(previousOwner, [this](bool ready) {
+        if(!ready)
+            qDebug() << "service is not ready, update device list anyway";
+        getDeviceInfo([this]{
+            refreshDevicePages();
+        });
+    });
 }
 
-void MainWindow::updateDeviceListWidget(int biotype)
+void MainWindow::refreshDevicePages()
 {
-    QListWidget *lw = nullptr;
+    /* 页面、设备列表和总览表格已经在合并设备表时更新过了 */
+    setCursor(Qt::ArrowCursor);
+    initBiometricPage();
+}
 
-    switch(biotype) {
+void MainWindow::on_tableViewDevices_doubleClicked(const QModelIndex &index)
+{
+    if(index.column() % DeviceTableModel::ColumnsPerDevice != DeviceTableModel::NameColumn)
+        return;
+
+    DeviceInfo *deviceInfo = deviceTableModel->deviceAt(index);
+    if(!deviceInfo)
+        return;
+
+    switch(deviceInfo->biotype) {
     case BIOTYPE_FINGERPRINT:
-        lw = ui->listWidgetFingerPrint;
+        ui->btnFingerPrint->click();
         break;
     case BIOTYPE_FINGERVEIN:
-        lw = ui->listWidgetFingerVein;
+        ui->btnFingerVein->click();
         break;
     case BIOTYPE_IRIS:
-        lw = ui->listWidgetIris;
+        ui->btnIris->click();
         break;
     case BIOTYPE_VOICEPRINT:
-        lw = ui->listWidgetVoicePrint;
+        ui->btnVoicePrint->click();
         break;
     }
-    if(!lw) return;
-
-    for(int row = 0; row < lw->count(); row++)
-    {
-        QListWidgetItem *item = lw->item(row);
-        QList<DeviceInfo *> list = deviceInfosMap[bioTypeToIndex(biotype)];
-        auto iter = std::find_if(list.begin(), list.end(),
-                              [&](DeviceInfo *deviceInfo){
-                return deviceInfo->device_shortname == item->text(); });
-        if(iter != std::end(list))
-            item->setTextColor((*iter)->device_available ? Qt::black : Qt::gray);
-
-    }
-}
-
-void MainWindow::updateDevice()
-{
-    setCursor(Qt::WaitCursor);
-    sleep(3);   //wait for service restart and dbus is ready
-    getDeviceInfo();
-    on_listWidgetDevicesType_currentRowChanged(ui->listWidgetDevicesType->currentRow());
-
-   /* for(int i = 0; i < __MAX_NR_BIOTYPES; i++){
-        for(auto deviceInfo : deviceInfosMap[i]){
-                ContentPane *contentPane = contentPaneMap[deviceInfo->device_shortname];
-                if(contentPane){
-            		contentPane->setDeviceInfo(deviceInfo);
-            		contentPane->showFeatures();
-                }else{
-                    addContentPane(deviceInfo);
-                }
-        }
-        updateDeviceListWidget(i);
-    }*/
-    initBiometricPage();
-    setCursor(Qt::ArrowCursor);
-     sortContentPane();
-}
-
-void MainWindow::on_tableWidgetDevices_cellDoubleClicked(int row, int column)
-{
-    if(column % 4 != 0)
-        return;
-    int index = row * 2 + column / 4;
-
-    if(index < deviceInfosMap[ui->listWidgetDevicesType->currentRow()].size()) {
-        int deviceType = ui->listWidgetDevicesType->currentRow();
-        DeviceInfo *deviceInfo =  deviceInfosMap[deviceType][index];
-        QListWidget *lw;
-        switch(deviceInfo->biotype) {
-        case BIOTYPE_FINGERPRINT:
-            lw = ui->listWidgetFingerPrint;
-            ui->btnFingerPrint->click();
-            break;
-        case BIOTYPE_FINGERVEIN:
-            lw = ui->listWidgetFingerVein;
-            ui->btnFingerVein->click();
-            break;
-        case BIOTYPE_IRIS:
-            lw = ui->listWidgetIris;
-            ui->btnIris->click();
-            break;
-        case BIOTYPE_VOICEPRINT:
-            lw = ui->listWidgetVoicePrint;
-            ui->btnVoicePrint->click();
-            break;
-        }
-        lw->setCurrentRow(index);
-    }
+    selectDevice(deviceInfo->device_id);
 }
 
+/**
+ * @brief 热插拔事件
+ * 集线器重新枚举时会连续收到多个事件，这里只记录每个设备最后的状态，
+ * 在本轮事件循环结束后统一更新一次界面
+ */
 void MainWindow::onUSBDeviceHotPlug(int drvid, int action, int devNumNow)
 {
     qDebug() << "device"<< (action > 0 ? "insert:" : "pull out:");
     qDebug() << "id:" << drvid;
-    for(int type : deviceInfosMap.keys()) {
-        auto &deviceInfoList = deviceInfosMap[type];
-        for(int i = 0; i < deviceInfoList.size(); i++) {
-            auto deviceInfo = deviceInfoList[i];
-            if(deviceInfo->device_id == drvid) {
-                qDebug() << "name:" << deviceInfo->device_shortname;
-
-                //更新结构体
-                deviceInfo->device_available = devNumNow;
-                //更新标签页中的设备状态
-                ContentPane *pane = contentPaneMap[deviceInfo->device_shortname];
-                pane->setDeviceAvailable(devNumNow);
-
-                if(type != ui->listWidgetDevicesType->currentRow())
-                {
-                    return;
-                }
-
-                int row = i / 2;
-                int column = i % 2 == 0 ? 1 : 5;
-                //更新表中的设备状态
-                QTableWidgetItem *item = ui->tableWidgetDevices->item(row, column);
-                setDeviceStatus(item, devNumNow > 0);
-                if(devNumNow > 0 ){
-                    sortContentPane();
-                    on_listWidgetDevicesType_currentRowChanged(ui->listWidgetDevicesType->currentRow());
-                }
-                return;
-            }
-        }
+
+    pendingHotPlug.insert(drvid, devNumNow);
+    if(!hotPlugScheduled) {
+        hotPlugScheduled = true;
+        QTimer::singleShot(0, this, &MainWindow::applyHotPlug);
     }
 }
 
-void MainWindow::setDeviceStatus(QTableWidgetItem *item, bool connected)
+void MainWindow::applyHotPlug()
 {
-    QString deviceStatus;
-    if(connected) {
-        deviceStatus = tr("Connected");
-        item->setTextColor(Qt::red);
+    hotPlugScheduled = false;
+
+    /* 页面、设备列表（包括排序）和总览表格都通过 DeviceRegistry::deviceChanged 更新 */
+    for(auto iter = pendingHotPlug.constBegin(); iter != pendingHotPlug.constEnd(); ++iter) {
+        DeviceInfo *deviceInfo = deviceRegistry->device(iter.key());
+        if(!deviceInfo)
+            continue;
+        qDebug() << "name:" << deviceInfo->device_shortname;
+        deviceRegistry->setDeviceAvailable(iter.key(), iter.value());
     }
-    else {
-        deviceStatus = tr("Unconnected");
-        item->setTextColor(Qt::black);
-    }
-    item->setText(deviceStatus);
+    pendingHotPlug.clear();
 }
 
-
 void MainWindow::onServiceStatusChanged(bool activate)
 {
     if(!activate)
@@ -19,10 +19,12 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTableWidgetItem>
-#include <QCheckBox>
+#include <QPointer>
+#include <QHash>
+#include <functional>
 #include "customtype.h"
 #include "contentpane.h"
+#include "commandrunner.h"
 
 #define KYLIN_USER_GUIDE_PATH "/"
 #define KYLIN_USER_GUIDE_SERVICE "com.kylinUserGuide.hotel"
@@ -32,7 +34,13 @@ namespace Ui {
 class MainWindow;
 }
 class QLabel;
+class QListView;
+class QStackedWidget;
 class AboutDialog;
+class BiometricProxy;
+class DeviceRegistry;
+class DeviceTableModel;
+class DeviceListModel;
 
 class MainWindow : public QMainWindow
 {
@@ -57,11 +65,13 @@ private slots:
     void on_btnVoicePrint_clicked();
     void on_btnStatus_clicked();
     void on_listWidgetDevicesType_currentRowChanged(int);
-    void on_tableWidgetDevices_cellDoubleClicked(int row, int column);
-    void onDriverStatusClicked();
-    void onDefaultDeviceChanged(bool checked);
-    bool changeDeviceStatus(DeviceInfo *deviceInfo);
+    void on_tableViewDevices_doubleClicked(const QModelIndex &index);
+    void changeDeviceStatus(DeviceInfo *deviceInfo);
+    void on_btnApplyDriverChanges_clicked();
+    void on_btnDiscardDriverChanges_clicked();
+    void updateDriverChangesBar(int count);
     void onUSBDeviceHotPlug(int, int, int);
+    void applyHotPlug();
 
 public slots:
     void onServiceStatusChanged(bool activate);
@@ -70,38 +80,55 @@ public slots:
 private:
 	void prettify();
     void initSysMenu();
-	void getDeviceInfo();
+	void getDeviceInfo(const std::function<void ()> &callback);
+    void setDeviceInfo(const QDBusPendingReply<int, QList<QDBusVariant> > &reply);
     void addContentPane(DeviceInfo *deviceInfo);
+    void removeContentPane(DeviceInfo *deviceInfo);
+    void updateContentPane(DeviceInfo *deviceInfo);
+    bool getPageWidgets(int biotype, QListView **lv, QStackedWidget **sw);
 	void initialize();
     void initDeviceTypeList();
+    void initDeviceTable();
 	void initBiometricPage();
+    void initDeviceLists();
 	void initDashboardBioAuthSection();
     QPixmap *getUserAvatar(QString username);
     void setCurrentUser();
     void changeBtnColor(QPushButton *btn);
     void setVerificationStatus(bool status);
     int bioTypeToIndex(int type);
-    bool restartService();
-    void updateDevice();
-    void updateDeviceListWidget(int biotype);
-    void setDeviceStatus(QTableWidgetItem *item, bool connected);
-    void raiseContentPane(DeviceInfo *deviceInfo);
+    int indexToBioType(int index);
+    void restartService();
+    typedef std::function<void (const QHash<int, bool> &)> DriverChangesCallback;
+    void applyDriverChanges(const QHash<int, bool> &changes,
+                            const DriverChangesCallback &callback);
+    bool runPrivilegedCommand(const QStringList &arguments,
+                              const CommandRunner::Callback &callback);
+    void updateDevice(const QString &previousOwner = QString());
+    void refreshDevicePages();
     void setLastDeviceSelected();
-    void sortContentPane();
+    void updateBiometricPage();
+    bool selectDevice(int deviceId);
     void showGuide(QString appName);
+    void prefetchCurrentPage();
+    void prefetchFeatures(QListView *lv);
+    void prefetchNext();
     int daemonIsNotRunning();
 
 /* Members */
 private:
 	Ui::MainWindow *ui;
     QLabel  *lblStatus;
-    //由于互斥的QButtonGroup会保证至少有一个被选中，所以这里不使用它
-    QList<QCheckBox*> btnGroup;
 	/* 用于和远端 DBus 对象交互的代理接口 */
-    QDBusInterface *serviceInterface;
+    BiometricProxy *serviceInterface;
 	int deviceCount;
-    QMap<int, QList<DeviceInfo *>> deviceInfosMap;
-	QMap<QString, ContentPane *> contentPaneMap;
+    DeviceRegistry *deviceRegistry;
+    DeviceListModel *deviceListModel;
+    DeviceTableModel *deviceTableModel;
+    QHash<int, ContentPane *> contentPaneMap;   //device_id -> ContentPane
+    /* 等待处理的热插拔事件，device_id -> 当前连接的设备数 */
+    QHash<int, int> pendingHotPlug;
+    bool hotPlugScheduled;
 	/* 通过命令行参数传入的用户名 */
     QString username;
     bool verificationStatus;    //生物识别开关状态
@@ -115,7 +142,12 @@ private:
 
     /* 服务被关闭时提示 */
     QLabel *lblPrompt;
-    DeviceInfo *lastDeviceInfo;
+    int lastDeviceId;   //更新设备后需要选中的设备，-1 表示没有
+    QPointer<CommandRunner> privilegedCommand;  //正在执行的提权命令
+
+    /* 空闲时逐个预取当前页面上其它设备的特征列表 */
+    QList<QPointer<ContentPane>> prefetchQueue;
+    QPointer<ContentPane> prefetchPane;
 };
 
 #endif // MAINWINDOW_H
@@ -17,8 +17,8 @@
 **/
 #include "messagedialog.h"
 #include "ui_messagedialog.h"
-#include <QFile>
 #include "xatom-helper.h"
+#include "dialogpool.h"
 
 MessageDialog::MessageDialog(int type, const QString &title, const QString &msg, QWidget *parent) :
     QDialog(parent),
@@ -27,22 +27,12 @@ MessageDialog::MessageDialog(int type, const QString &title, const QString &msg,
     ui->setupUi(this);
     setWindowFlags(/*Qt::FramelessWindowHint |*/ Qt::Window);
 
-    ui->btnCancel->hide();
+    defaultOkText = ui->btnOK->text();
+    defaultCancelText = ui->btnCancel->text();
+    defaultAlignment = ui->lblMessage->alignment();
+    reset(type, title, msg);
 
-    if(type == Error)
-        ui->lblMessage->setStyleSheet("color:red");
-    else if(type == Question)
-        ui->btnCancel->show();
-
-    setTitle(title);
-    setMessage(msg);
-
-
-    QFile qssFile(":/css/assets/promptdialog.qss");
-    qssFile.open(QFile::ReadOnly);
-    QString styleSheet = QLatin1String(qssFile.readAll());
-    this->setStyleSheet(styleSheet);
-    qssFile.close();
+    this->setStyleSheet(DialogPool::styleSheet());
 
    // ui->btnClose->setIcon(QIcon(":/images/assets/close.png"));
     ui->btnClose->setFlat(true);
@@ -70,6 +60,25 @@ MessageDialog::~MessageDialog()
     delete ui;
 }
 
+/**
+ * @brief 按新的类型和内容重新设置，供 DialogPool 复用
+ */
+void MessageDialog::reset(int type, const QString &title, const QString &msg)
+{
+    ui->btnCancel->setVisible(type == Question);
+    ui->lblMessage->setStyleSheet(type == Error ? "color:red" : "");
+    ui->lblMessage->setAlignment(defaultAlignment);
+    ui->btnOK->setText(defaultOkText);
+    ui->btnCancel->setText(defaultCancelText);
+
+    qDeleteAll(messageLabels);
+    messageLabels.clear();
+
+    setWindowTitle(QString());
+    setTitle(title);
+    setMessage(msg);
+}
+
 void MessageDialog::setTitle(const QString &text)
 {
     ui->lblTitle->setText(text);
@@ -100,5 +109,6 @@ void MessageDialog::setMessageList(const QStringList &textList)
         QLabel *label = new QLabel(text, this);
         label->setFont(QFont("Sans Serif", 10));
         ui->messageLayout->addWidget(label);
+        messageLabels.append(label);
     }
 }
@@ -19,6 +19,9 @@
 #define MESSAGEDIALOG_H
 
 #include <QDialog>
+#include <QList>
+
+class QLabel;
 
 namespace Ui {
 class MessageDialog;
@@ -32,6 +35,7 @@ public:
     explicit MessageDialog(int type = Normal, const QString &title = "",
                            const QString &msg = "", QWidget *parent = 0);
     ~MessageDialog();
+    void reset(int type, const QString &title = "", const QString &msg = "");
     void setTitle(const QString &text);
     void setMessage(const QString &text);
     void setMessageList(const QStringList &textList);
@@ -41,6 +45,10 @@ public:
 
 private:
     Ui::MessageDialog *ui;
+    QString defaultOkText;
+    QString defaultCancelText;
+    Qt::Alignment defaultAlignment;
+    QList<QLabel *> messageLabels;  //setMessageList 添加的标签
 };
 
 #endif // MESSAGEDIALOG_H
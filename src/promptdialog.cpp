@@ -17,26 +17,40 @@
 **/
 #include "promptdialog.h"
 #include "ui_promptdialog.h"
-#include <QMovie>
 #include <QPushButton>
 #include <QDebug>
 #include <QKeyEvent>
 #include <QStandardItemModel>
-#include <pwd.h>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
 #include "servicemanager.h"
+#include "biometricproxy.h"
 #include "xatom-helper.h"
+#include "usernameresolver.h"
+#include "devicesignalrouter.h"
+#include "imagecache.h"
+#include "frameanimator.h"
+#include "dialogpool.h"
 
-PromptDialog::PromptDialog(QDBusInterface *service,  int bioType,
-                           int deviceId, int uid, QWidget *parent)
+/*
+ * 对话框由 DialogPool 创建并复用，每次使用前调用 reset 设置设备和用户，
+ * 使用后由 recycle 清理，构造函数中只做与具体操作无关的初始化
+ */
+PromptDialog::PromptDialog(BiometricProxy *service, QWidget *parent)
     : QDialog(parent),
       ui(new Ui::PromptDialog),
       serviceInterface(service),
-      type(bioType),
-      deviceId(deviceId),
-      uid(uid),
+      type(-1),
+      deviceId(-1),
+      uid(-1),
       ops(IDLE),
       isProcessed(false),
-      opsResult(UNDEFINED)
+      opsResult(UNDEFINED),
+      notifyFetching(false),
+      notifyPending(false),
+      promptTimer(new QTimer(this)),
+      session(0)
 {
 	ui->setupUi(this);
     setWindowFlags(Qt::Window);
@@ -50,32 +64,27 @@ PromptDialog::PromptDialog(QDBusInterface *service,  int bioType,
     ui->btnClose->setIcon(QIcon::fromTheme("window-close-symbolic"));
 
 	/* 设置 CSS */
-	QFile qssFile(":/css/assets/promptdialog.qss");
-	qssFile.open(QFile::ReadOnly);
-	QString styleSheet = QLatin1String(qssFile.readAll());
-	this->setStyleSheet(styleSheet);
-	qssFile.close();
+	this->setStyleSheet(DialogPool::styleSheet());
     ui->treeViewResult->hide();
-    ui->lblImage->setPixmap(getImage(type));
+    animator = new FrameAnimator(ui->lblImage, AnimationPtr(), this);
 
-    movie = new QMovie(getGif(type));
-
-    connect(serviceInterface, SIGNAL(StatusChanged(int,int)),
-            this, SLOT(onStatusChanged(int,int)));
+    QScreen *screen = QGuiApplication::primaryScreen();
+    qreal refreshRate = screen && screen->refreshRate() > 0 ? screen->refreshRate() : 60;
+    promptInterval = qMax(1, qRound(1000 / refreshRate));
+    promptTimer->setSingleShot(true);
+    connect(promptTimer, &QTimer::timeout, this, &PromptDialog::flushNotifyPrompt);
 
     ServiceManager *sm = ServiceManager::instance();
     connect(sm, &ServiceManager::serviceStatusChanged,
             this, [&](bool activate){
-        if(!activate)
+        /* 池中空闲的对话框不处理 */
+        if(!activate && isVisible())
         {
             close();
         }
     });
 
 
-    connect(serviceInterface, SIGNAL(ProcessChanged(int,QString,int,QString)),
-            this, SLOT(onProcessChanged(int,QString,int,QString)));
-
     MotifWmHints hints;
     hints.flags = MWM_HINTS_FUNCTIONS|MWM_HINTS_DECORATIONS;
     hints.functions = MWM_FUNC_ALL;
@@ -89,6 +98,75 @@ PromptDialog::~PromptDialog()
 	delete ui;
 }
 
+/**
+ * @brief 准备一次新的操作
+ */
+void PromptDialog::reset(int bioType, int deviceId, int uid)
+{
+    recycle();
+
+    type = bioType;
+    this->deviceId = deviceId;
+    this->uid = uid;
+    isProcessed = false;
+    opsResult = UNDEFINED;
+
+    ui->lblTitle->clear();
+    ui->lblPrompt->clear();
+    ui->lblPrompt->setStyleSheet(QString());
+    ui->btnClose->setEnabled(true);
+
+    /* 去掉上一次的搜索结果 */
+    if(!ui->treeViewResult->isHidden()) {
+        ui->treeViewResult->hide();
+        setFixedHeight(height() - 100);
+    }
+    QAbstractItemModel *model = ui->treeViewResult->model();
+    ui->treeViewResult->setModel(nullptr);
+    delete model;
+
+    /* 动画帧由所有对话框共用，只在第一次使用时解码 */
+    animator->setAnimation(ImageCache::instance()->animation(getGif(type)));
+    setImage(getImage(type));
+
+    /* 只接收本设备的信号 */
+    DeviceSignalRouter::instance()->addHandler(deviceId, this,
+            [this](int status) {
+        onStatusChanged(this->deviceId, status);
+    }, [this](const QString &aa, int statusType, const QString &bb) {
+        onProcessChanged(this->deviceId, aa, statusType, bb);
+    });
+}
+
+/**
+ * @brief 使用结束，放回池中之前调用
+ * 之后到达的异步应答不再处理，并注销设备信号
+ */
+void PromptDialog::recycle()
+{
+    session++;
+    ops = IDLE;
+    notifyFetching = false;
+    notifyPending = false;
+    promptTimer->stop();
+    pendingPrompt.clear();
+    animator->stop();
+    DeviceSignalRouter::instance()->removeHandlers(this);
+}
+
+/**
+ * @brief 挂接只在本次使用中有效的回调
+ */
+template <typename Reply, typename Func>
+void PromptDialog::watchSession(const Reply &reply, Func callback)
+{
+    int serial = session;
+    watchReply(reply, this, [this, serial, callback](const Reply &result) {
+        if(serial == session)
+            callback(result);
+    });
+}
+
 void PromptDialog::setTitle(int opsType)
 {
     QString title = EnumToString::transferBioType(type);
@@ -113,21 +191,33 @@ void PromptDialog::setTitle(int opsType)
  */
 void PromptDialog::setPrompt(const QString &text)
 {
+    /* 直接设置的提示（操作结果等）优先于还没有刷新的通知 */
+    promptTimer->stop();
+    pendingPrompt.clear();
+    promptClock.start();
+
     ui->lblPrompt->setText(text);
     ui->lblPrompt->setWordWrap(true);
     ui->lblPrompt->adjustSize();
 }
 
+/**
+ * @brief 显示静态图片，同时停止动画
+ */
+void PromptDialog::setImage(const QPixmap &pixmap)
+{
+    animator->stop();
+    ui->lblImage->setPixmap(pixmap);
+}
+
 void PromptDialog::setProcessed(bool val)
 {
     isProcessed = val;
     if(isProcessed){
-        ui->lblImage->setPixmap(QPixmap("/usr/share/ukui-biometric/images/huawei/00.svg"));
+        setImage(ImageCache::instance()->progressFrame(0));
     }
     else{
-        ui->lblImage->setPixmap(getImage(type));
-        if(!movie)
-            movie = new QMovie(getGif(type));
+        setImage(getImage(type));
     }
 }
 
@@ -145,11 +235,8 @@ void PromptDialog::keyPressEvent(QKeyEvent *event)
 
 void PromptDialog::on_btnClose_clicked()
 {
-    QList<QVariant> args;
-    args << QVariant(deviceId) << QVariant(5);
-    serviceInterface->callWithCallback("StopOps", args, this,
-                        SLOT(StopOpsCallBack(const QDBusMessage &)),
-                        SLOT(errorCallBack(const QDBusError &)));
+    watchSession(serviceInterface->StopOps(deviceId, 5),
+                 [this](const QDBusPendingReply<int> &reply) { StopOpsCallBack(reply); });
     setPrompt(tr("In progress, please wait..."));
 }
 
@@ -158,7 +245,7 @@ PromptDialog::Result PromptDialog::getResult()
     return opsResult;
 }
 
-void PromptDialog::setSearchResult(bool isAdmin, const QList<SearchResult> &searchResultList)
+void PromptDialog::setSearchResult(bool isAdmin, const QVector<SearchResult> &searchResultList)
 {
     QStandardItemModel *model = new QStandardItemModel(ui->treeViewResult);
     if(isAdmin)
@@ -171,13 +258,28 @@ void PromptDialog::setSearchResult(bool isAdmin, const QList<SearchResult> &sear
         QList<QStandardItem*> row;
         row.append(new QStandardItem(QString::number(i+1)));
         if(isAdmin) {
-            struct passwd *pwd = getpwuid(ret.uid);
-            row.append(new QStandardItem(QString(pwd->pw_name)));
+            QStandardItem *userItem =
+                    new QStandardItem(UserNameResolver::instance()->userName(ret.uid));
+            userItem->setData(ret.uid, Qt::UserRole);
+            row.append(userItem);
         }
         row.append(new QStandardItem(ret.indexName));
         model->appendRow(row);
     }
 
+    /* 用户名解析完成后更新占位的 uid */
+    if(isAdmin) {
+        connect(UserNameResolver::instance(), &UserNameResolver::userNamesResolved,
+                model, [model](const QList<int> &uids) {
+            for(int row = 0; row < model->rowCount(); row++) {
+                QStandardItem *userItem = model->item(row, 1);
+                int uid = userItem->data(Qt::UserRole).toInt();
+                if(uids.contains(uid))
+                    userItem->setText(UserNameResolver::instance()->userName(uid));
+            }
+        });
+    }
+
     ui->treeViewResult->setModel(model);
     ui->treeViewResult->show();
     this->setFixedHeight(height() + 100);
@@ -198,27 +300,14 @@ QString PromptDialog::getGif(int type)
     return QString();
 }
 
-QString PromptDialog::getImage(int type)
+QPixmap PromptDialog::getImage(int type)
 {
-    switch(type) {
-    case BIOTYPE_FINGERPRINT:
-        return "/usr/share/ukui-biometric/images/FingerPrint.png";
-    case BIOTYPE_FINGERVEIN:
-        return "/usr/share/ukui-biometric/images/FingerVein.png";
-    case BIOTYPE_IRIS:
-        return "/usr/share/ukui-biometric/images/Iris.png";
-    case BIOTYPE_VOICEPRINT:
-        return "/usr/share/ukui-biometric/images/VoicePrint.png";
-    }
-    return QString();
+    return ImageCache::instance()->bioTypeImage(type);
 }
 
 
 int PromptDialog::enroll(int drvId, int uid, int idx, const QString &idxName)
 {
-    QList<QVariant> args;
-    args << drvId << uid << idx << idxName;
-
     this->setTitle(ENROLL);
     this->setPrompt(tr("Permission is required.\n"
                        "Please authenticate yourself to continue"));
@@ -228,18 +317,21 @@ int PromptDialog::enroll(int drvId, int uid, int idx, const QString &idxName)
      * 异步回调参考资料：
      * https://github.com/RalfVB/SQEW-OS/blob/master/src/module/windowmanager/compton.cpp
      */
-    serviceInterface->callWithCallback("Enroll", args, this,
-                        SLOT(enrollCallBack(const QDBusMessage &)),
-                        SLOT(errorCallBack(const QDBusError &)));
+    watchSession(serviceInterface->Enroll(drvId, uid, idx, idxName),
+                 [this](const QDBusPendingReply<int> &reply) { enrollCallBack(reply); });
     ops = ENROLL;
 
     return exec();
 }
 
-void PromptDialog::enrollCallBack(const QDBusMessage &reply)
+void PromptDialog::enrollCallBack(const QDBusPendingReply<int> &reply)
 {
-    int result;
-    result = reply.arguments()[0].value<int>();
+    if(reply.isError()) {
+        errorCallBack(reply.error());
+        return;
+    }
+
+    int result = reply.value();
     qDebug() << "Enroll result: " << result;
 
     ui->btnClose->setEnabled(true);
@@ -261,24 +353,24 @@ void PromptDialog::enrollCallBack(const QDBusMessage &reply)
 
 int PromptDialog::verify(int drvId, int uid, int idx)
 {
-    QList<QVariant> args;
-    args << drvId << uid << idx;
-
     this->setTitle(VERIFY);
 
-    serviceInterface->callWithCallback("Verify", args, this,
-                        SLOT(verifyCallBack(const QDBusMessage &)),
-                        SLOT(errorCallBack(const QDBusError &)));
+    watchSession(serviceInterface->Verify(drvId, uid, idx),
+                 [this](const QDBusPendingReply<int> &reply) { verifyCallBack(reply); });
     ops = VERIFY;
 
-//    movie->start();
+//    animator->start();
     return exec();
 }
 
-void PromptDialog::verifyCallBack(const QDBusMessage &reply)
+void PromptDialog::verifyCallBack(const QDBusPendingReply<int> &reply)
 {
-    int result;
-    result = reply.arguments()[0].value<int>();
+    if(reply.isError()) {
+        errorCallBack(reply.error());
+        return;
+    }
+
+    int result = reply.value();
     qDebug() << "Verify result: " << result;
 
     if(result >= 0) {
@@ -288,7 +380,7 @@ void PromptDialog::verifyCallBack(const QDBusMessage &reply)
     } else if(result == DBUS_RESULT_NOTMATCH) {
         setPrompt(tr("Not Match"));
         if(!isProcessed)
-            ui->lblImage->setPixmap(getImage(type));
+            setImage(getImage(type));
         //showClosePrompt();
     } else {
         handleErrorResult(result);
@@ -299,40 +391,32 @@ void PromptDialog::verifyCallBack(const QDBusMessage &reply)
 
 int PromptDialog::search(int drvId, int uid, int idxStart, int idxEnd)
 {
-    QList<QVariant> args;
-    args << drvId << uid << idxStart << idxEnd;
-
     this->setTitle(SEARCH);
 
-    serviceInterface->callWithCallback("Search", args, this,
-                        SLOT(searchCallBack(const QDBusMessage &)),
-                        SLOT(errorCallBack(const QDBusError &)));
+    watchSession(serviceInterface->Search(drvId, uid, idxStart, idxEnd),
+                 [this](const SearchReply &reply) { searchCallBack(reply); });
 
     ops = SEARCH;
 
-//    movie->start();
+//    animator->start();
     return exec();
 }
 
-void PromptDialog::searchCallBack(const QDBusMessage &reply)
+void PromptDialog::searchCallBack(const SearchReply &reply)
 {
-    int result;
-    result = reply.arguments()[0].value<int>();
+    if(reply.isError()) {
+        errorCallBack(reply.error());
+        return;
+    }
+
+    int result = reply.argumentAt<0>();
     qDebug() << "Verify result: " << result;
 
     if(result > 0) {
         setPrompt(tr("Search Result"));
         int count  = result;
-        QDBusArgument argument = reply.arguments().at(1).value<QDBusArgument>();
-        QList<QVariant> variantList;
-        argument >> variantList;
-        QList<SearchResult> results;
-        for(int i = 0; i < count; i++) {
-            QDBusArgument arg =variantList.at(i).value<QDBusArgument>();
-            SearchResult ret;
-            arg >> ret;
-            results.append(ret);
-        }
+        QVector<SearchResult> results =
+                decodeVariantArray<SearchResult>(reply.reply(), 1, count);
         this->setSearchResult(isAdmin(uid), results);
         opsResult = SUCESS;
     }
@@ -341,12 +425,16 @@ void PromptDialog::searchCallBack(const QDBusMessage &reply)
     else
         handleErrorResult(result);
 
-    ui->lblImage->setPixmap(getImage(type));
+    setImage(getImage(type));
+    ops = IDLE;
 }
 
-void PromptDialog::StopOpsCallBack(const QDBusMessage &reply)
+void PromptDialog::StopOpsCallBack(const QDBusPendingReply<int> &reply)
 {
-    int ret = reply.arguments().at(0).toInt();
+    if(reply.isError()) {
+        errorCallBack(reply.error());
+        return;
+    }
     accept();
 }
 
@@ -358,21 +446,15 @@ void PromptDialog::errorCallBack(const QDBusError &error)
 
 void PromptDialog::closeEvent(QCloseEvent *event)
 {
-    QList<QVariant> args;
-    args << QVariant(deviceId) << QVariant(5);
-    serviceInterface->callWithCallback("StopOps", args, this,
-                    SLOT(StopOpsCallBack(const QDBusMessage &)),
-                    SLOT(errorCallBack(const QDBusError &)));
+    watchSession(serviceInterface->StopOps(deviceId, 5),
+                 [this](const QDBusPendingReply<int> &reply) { StopOpsCallBack(reply); });
 
 }
 
 void PromptDialog::onProcessChanged(int drvId,QString  aa, int statusType,QString bb)
 {
-    int count = statusType * 15 / 100;
-    QString filename = QString("/usr/share/ukui-biometric/images/huawei/") + (count < 10 ? "0" : "") +
-            QString::number(count) + ".svg";
-
-    ui->lblImage->setPixmap(QPixmap(filename));
+    /* 进度帧已经解码缓存，这里不再读盘和解析 SVG */
+    setImage(ImageCache::instance()->progressFrame(statusType));
 }
 
 void PromptDialog::onStatusChanged(int drvId, int statusType)
@@ -382,40 +464,113 @@ void PromptDialog::onStatusChanged(int drvId, int statusType)
 
     ui->btnClose->setEnabled(true);
 
+    if(ops == IDLE)
+        return;
+
+    /* 正在获取时只记下有新的通知，当前请求返回后只取一次最新的 */
+    if(notifyFetching) {
+        notifyPending = true;
+        return;
+    }
+    fetchNotify();
+}
+
+void PromptDialog::fetchNotify()
+{
+    notifyFetching = true;
+    notifyPending = false;
+
     //过滤掉当录入时使用生物识别授权接收到的认证的提示信息
     if(ops == ENROLL) {
-        QDBusMessage reply = serviceInterface->call("UpdateStatus", drvId);
-        if(reply.type() == QDBusMessage::ErrorMessage) {
-            qDebug() << "DBUS: " << reply.errorMessage();
-            return;
-        }
-        int devStatus = reply.arguments().at(3).toInt();
-        qDebug() << devStatus;
-
-        if(!(devStatus >= 201 && devStatus < 203)) {
-            return;
-        }
+        watchSession(serviceInterface->UpdateStatus(deviceId),
+                     [this](const QDBusPendingReply<int, int, int, int, int, int> &reply) {
+            if(dropNotifyReply())
+                return;
+            if(reply.isError()) {
+                qDebug() << "DBUS: " << reply.error().message();
+                finishNotifyFetch();
+                return;
+            }
+            int devStatus = reply.argumentAt<3>();
+            qDebug() << devStatus;
+
+            if(devStatus >= 201 && devStatus < 203)
+                showNotifyMessage();
+            else
+                finishNotifyFetch();
+        });
     }
-    else if(ops == IDLE)
+    else
     {
-        return;
+        showNotifyMessage();
+    }
+}
+
+/**
+ * @brief 判断应答是否已经过时
+ * 只在操作已经结束时丢弃（对话框复用后的应答由 watchSession 丢弃）；
+ * 其它应答总比界面上显示的新，照常处理
+ */
+bool PromptDialog::dropNotifyReply()
+{
+    if(ops == IDLE) {
+        notifyFetching = false;
+        notifyPending = false;
+        return true;
     }
+    return false;
+}
+
+/**
+ * @brief 一次获取结束，等待期间又收到过通知时再取一次最新的
+ */
+void PromptDialog::finishNotifyFetch()
+{
+    notifyFetching = false;
+    if(notifyPending)
+        fetchNotify();
+}
 
-    if(!isProcessed && movie->state() != QMovie::Running)
+void PromptDialog::showNotifyMessage()
+{
+    if(!isProcessed && !animator->isRunning())
     {
-        ui->lblImage->setMovie(movie);
-        movie->start();
+        animator->start();
     }
 
-    QDBusMessage notifyReply = serviceInterface->call("GetNotifyMesg", drvId);
-    if(notifyReply.type() == QDBusMessage::ErrorMessage) {
-        qDebug() << "DBUS: " << notifyReply.errorMessage();
+    watchSession(serviceInterface->GetNotifyMesg(deviceId),
+                 [this](const QDBusPendingReply<QString> &notifyReply) {
+        if(dropNotifyReply())
+            return;
+        if(notifyReply.isError()) {
+            qDebug() << "DBUS: " << notifyReply.error().message();
+        } else {
+            QString prompt = notifyReply.value();
+            qDebug() << prompt;
+            showNotifyPrompt(prompt);
+        }
+        finishNotifyFetch();
+    });
+}
+
+/**
+ * @brief 显示通知的提示信息，距上次刷新不足一帧时推迟到下一帧，只显示最新的一条
+ */
+void PromptDialog::showNotifyPrompt(const QString &prompt)
+{
+    pendingPrompt = prompt;
+    if(promptTimer->isActive())
         return;
-    }
-    QString prompt = notifyReply.arguments().at(0).toString();
-    qDebug() << prompt;
 
-    setPrompt(prompt);
+    qint64 elapsed = promptClock.isValid() ? promptClock.elapsed() : promptInterval;
+    promptTimer->start(qMax<qint64>(0, promptInterval - elapsed));
+}
+
+void PromptDialog::flushNotifyPrompt()
+{
+    QString prompt = pendingPrompt;
+    if(prompt != ui->lblPrompt->text())
+        setPrompt(prompt);
 }
 
 void PromptDialog::handleErrorResult(int error)
@@ -423,15 +578,17 @@ void PromptDialog::handleErrorResult(int error)
     switch(error) {
     case DBUS_RESULT_ERROR: {
         //操作失败，需要进一步获取失败原因
-        QDBusMessage msg = serviceInterface->call("GetOpsMesg", deviceId);
-        if(msg.type() == QDBusMessage::ErrorMessage)
-        {
-            qDebug() << "UpdateStatus error: " << msg.errorMessage();
-            setPrompt(tr("D-Bus calling error"));
-            return;
-        }
-        setPrompt(msg.arguments().at(0).toString());
-        qDebug() << "GetOpsMesg: deviceId--" << deviceId;
+        watchSession(serviceInterface->GetOpsMesg(deviceId),
+                     [this](const QDBusPendingReply<QString> &msg) {
+            if(msg.isError())
+            {
+                qDebug() << "GetOpsMesg error: " << msg.error().message();
+                setPrompt(tr("D-Bus calling error"));
+                return;
+            }
+            setPrompt(msg.value());
+            qDebug() << "GetOpsMesg: deviceId--" << deviceId;
+        });
         break;
     }
     case DBUS_RESULT_DEVICEBUSY:
@@ -449,7 +606,7 @@ void PromptDialog::handleErrorResult(int error)
     }
 
     ui->lblPrompt->setStyleSheet("QLabel{color: red;}");
-    ui->lblImage->setPixmap(getImage(type));
+    setImage(getImage(type));
     qDebug() << QString("Error:(%1)%2")
                 .arg(QString::number(error))
                 .arg(ui->lblPrompt->text());
@@ -475,11 +632,15 @@ void PromptDialog::setFailed()
 
 void PromptDialog::showClosePrompt()
 {
-    ui->lblImage->setPixmap(QIcon::fromTheme("ukui-dialog-success").pixmap(QSize(64,64)));
+    setImage(QIcon::fromTheme("ukui-dialog-success").pixmap(QSize(64,64)));
     QString prompt = QString("<font size = '4'>%1</font>").arg(ui->lblPrompt->text())
             + "<br><br>" +
             tr("<font size='2'>the window will be closed after two second</font>");
     setPrompt(prompt);
 
-    QTimer::singleShot(2000, this, [&]{accept();});
+    int serial = session;
+    QTimer::singleShot(2000, this, [this, serial]{
+        if(serial == session)
+            accept();
+    });
 }
@@ -21,7 +21,12 @@
 #include "customtype.h"
 
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QPixmap>
 
+class BiometricProxy;
+class QTimer;
+class FrameAnimator;
 namespace Ui {
 class PromptDialog;
 }
@@ -31,15 +36,17 @@ class PromptDialog : public QDialog
 	Q_OBJECT
 
 public:
-    explicit PromptDialog(QDBusInterface *service, int bioType,
-                          int deviceId, int uid, QWidget *parent = 0);
+    explicit PromptDialog(BiometricProxy *service, QWidget *parent = 0);
 	~PromptDialog();
     enum Result {SUCESS, ERROR, UNDEFINED};
 
 public:
+    void reset(int bioType, int deviceId, int uid);
+    void recycle();
     void setTitle(int opsType);
     void setPrompt(const QString &text);
     void setProcessed(bool val);
+    void setImage(const QPixmap &pixmap);
 
     int enroll(int drvId, int uid, int idx, const QString &idxName);
     int verify(int drvId, int uid, int idx);
@@ -53,10 +60,25 @@ protected:
 private:
     void setFailed();
     QString getGif(int type);
-    QString getImage(int type);
+    QPixmap getImage(int type);
     void handleErrorResult(int error);
     void showClosePrompt();
-    void setSearchResult(bool isAdmin, const QList<SearchResult> &searchResultList);
+    void setSearchResult(bool isAdmin, const QVector<SearchResult> &searchResultList);
+    template <typename Reply, typename Func>
+    void watchSession(const Reply &reply, Func callback);
+    void fetchNotify();
+    bool dropNotifyReply();
+    void finishNotifyFetch();
+    void showNotifyMessage();
+    void showNotifyPrompt(const QString &prompt);
+    void flushNotifyPrompt();
+
+    typedef QDBusPendingReply<int, QList<QDBusVariant> > SearchReply;
+    void enrollCallBack(const QDBusPendingReply<int> &reply);
+    void verifyCallBack(const QDBusPendingReply<int> &reply);
+    void searchCallBack(const SearchReply &reply);
+    void StopOpsCallBack(const QDBusPendingReply<int> &reply);
+    void errorCallBack(const QDBusError &error);
 
 signals:
     void canceled(); /* 自定义信号，用于触发主窗口内的 slot */
@@ -65,16 +87,11 @@ private slots:
     void on_btnClose_clicked();
     void onStatusChanged(int, int);
     void onProcessChanged(int, QString,int,QString);
-    void enrollCallBack(const QDBusMessage &);
-    void verifyCallBack(const QDBusMessage &);
-    void searchCallBack(const QDBusMessage &);
-    void StopOpsCallBack(const QDBusMessage &);
-    void errorCallBack(const QDBusError &);
 
 private:
 	Ui::PromptDialog *ui;
-    QDBusInterface *serviceInterface;
-    QMovie *movie;
+    BiometricProxy *serviceInterface;
+    FrameAnimator *animator;
     int type;
     int deviceId;
     int uid;
@@ -82,6 +99,16 @@ private:
     enum OPS{IDLE, ENROLL, VERIFY, SEARCH} ops;
     Result opsResult;
     bool isProcessed;
+
+    /* 提示信息的获取：同一时间只有一个请求，期间收到的通知合并为一次 */
+    bool notifyFetching;
+    bool notifyPending;
+    /* 提示信息的刷新不超过屏幕刷新率 */
+    QString pendingPrompt;
+    QTimer *promptTimer;
+    QElapsedTimer promptClock;
+    int promptInterval;
+    int session;    //每次复用加一，用来丢弃上一次使用中的异步应答
 };
 
 #endif // PROMPTDIALOG_H
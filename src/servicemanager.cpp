@@ -18,15 +18,34 @@
 
 #include "servicemanager.h"
 #include <QDebug>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
 #include "customtype.h"
 #include "messagedialog.h"
+#include "biometricproxy.h"
+
+#define SERVICE_WAIT_TIMEOUT    10000   /* 等待服务就绪的最长时间（毫秒）*/
+#define SERVICE_RESTART_GRACE   1000    /* 不知道操作前的服务时，确认可用前的等待时间 */
+#define SERVICE_PROBE_MIN       50      /* 探测间隔从 50ms 开始倍增 */
+#define SERVICE_PROBE_MAX       800
 
 ServiceManager *ServiceManager::instance_ = nullptr;
 
+struct ServiceManager::ServiceWaiter {
+    QString previousOwner;
+    std::function<void (bool)> callback;
+    QElapsedTimer elapsed;
+    int backoff = SERVICE_PROBE_MIN;
+    bool probing = false;
+    bool finished = false;
+    QTimer *retryTimer = nullptr;
+    QMetaObject::Connection ownerConnection;
+};
+
 ServiceManager::ServiceManager(QObject *parent)
     : QObject(parent),
-      dbusService(nullptr),
-      bioService(nullptr)
+      dbusService(nullptr)
 {
     init();
 }
@@ -35,12 +54,10 @@ void ServiceManager::init()
 {
     if(!dbusService)
     {
-        dbusService = new QDBusInterface(FD_DBUS_SERVICE,
-                                         FD_DBUS_PATH,
-                                         FD_DBUS_INTERFACE,
-                                         QDBusConnection::systemBus());
-        connect(dbusService, SIGNAL(NameOwnerChanged(QString, QString, QString)),
-                this, SLOT(onDBusNameOwnerChanged(QString,QString,QString)));
+        /* 使用连接自带的 org.freedesktop.DBus 代理，避免构造 QDBusInterface 时的同步自省 */
+        dbusService = BiometricProxy::busConnection().interface();
+        connect(dbusService, &QDBusConnectionInterface::serviceOwnerChanged,
+                this, &ServiceManager::onDBusNameOwnerChanged);
     }
 }
 
@@ -53,18 +70,6 @@ ServiceManager *ServiceManager::instance()
     return instance_;
 }
 
-bool ServiceManager::connectToService()
-{
-    if(!bioService)
-    {
-        bioService = new QDBusInterface(DBUS_SERVICE,
-                                        DBUS_PATH,
-                                        DBUS_INTERFACE,
-                                        QDBusConnection::systemBus());
-    }
-    return bioService->isValid();
-}
-
 void ServiceManager::onDBusNameOwnerChanged(const QString &name,
                                             const QString &oldOwner,
                                             const QString &newOwner)
@@ -73,42 +78,147 @@ void ServiceManager::onDBusNameOwnerChanged(const QString &name,
     {
         qDebug() << "service status changed:"
                  << (newOwner.isEmpty() ? "inactivate" : "activate");
+        owner = newOwner;
         Q_EMIT serviceStatusChanged(!newOwner.isEmpty());
     }
 }
 
 /*!
- * \brief checkServiceExist
- * 检查生物识别后台服务是否已启动
+ * \brief ServiceManager::checkService
+ * 检查生物识别后台服务是否已启动、API版本是否兼容。
+ * 两个查询互不依赖，同时发出，都返回后通过 serviceChecked 报告结果，
+ * 调用方无需等待，可以先显示主窗口。
  */
-bool ServiceManager::serviceExists()
+void ServiceManager::checkService()
 {
-    QDBusReply<bool> reply = dbusService->call("NameHasOwner", DBUS_SERVICE);
-    if(!reply.isValid())
-    {
-        qDebug() << "check service exists error:" << reply.error();
-        return false;
-    }
-    return reply.value();
+    struct ServiceCheck {
+        int pending = 2;
+        bool exists = false;
+        bool compatible = false;
+    };
+    std::shared_ptr<ServiceCheck> check = std::make_shared<ServiceCheck>();
+
+    auto finish = [this, check] {
+        if(--check->pending > 0)
+            return;
+        if(!check->exists)
+            Q_EMIT serviceChecked(ServiceNotStarted);
+        else if(!check->compatible)
+            Q_EMIT serviceChecked(ApiNotCompatible);
+        else
+            Q_EMIT serviceChecked(ServiceReady);
+    };
+
+    /* 服务不存在时返回 NameHasNoOwner 错误 */
+    QDBusPendingReply<QString> ownerReply = dbusService->asyncCall("GetNameOwner", DBUS_SERVICE);
+    watchReply(ownerReply, this, [this, check, finish](const QDBusPendingReply<QString> &reply) {
+        if(reply.isError()) {
+            qDebug() << "check service exists error:" << reply.error();
+        } else {
+            owner = reply.value();
+            check->exists = !owner.isEmpty();
+        }
+        finish();
+    });
+
+    QDBusPendingReply<int> apiReply =
+            BiometricProxy::instance()->CheckAppApiVersion(APP_API_MAJOR,
+                                                           APP_API_MINOR,
+                                                           APP_API_FUNC);
+    watchReply(apiReply, this, [check, finish](const QDBusPendingReply<int> &reply) {
+        if(reply.isError())
+            qDebug() << "check api compatibility error: " << reply.error();
+        else
+            check->compatible = (reply.value() == 0);
+        finish();
+    });
+}
+
+QString ServiceManager::serviceOwner() const
+{
+    return owner;
 }
 
 /*!
- * \brief ServiceManager::apiCompatible
- * 检查API版本和服务的版本是否兼容
+ * \brief ServiceManager::waitForService
+ * \param previousOwner 操作（重启服务、启停驱动）之前服务的唯一连接名
+ * \param callback      服务就绪或超时后调用，参数表示服务是否就绪
+ * 服务重新获得总线名（NameOwnerChanged）时立即探测，其余时间以递增的间隔
+ * 调用 CheckAppApiVersion 探测，服务一旦应答就回调，不再固定等待。
+ * 给出了 previousOwner 时，必须等到服务换了连接名（旧进程退出、新进程启动）才视为就绪，
+ * 否则可能在旧进程退出前就与它通信，拿到过时的设备状态；直到超时为止。
+ * 没有给出 previousOwner 时无法判断服务是否重启过，应答后再等待一小段时间即视为就绪。
  */
-bool ServiceManager::apiCompatible()
+void ServiceManager::waitForService(const QString &previousOwner,
+                                    const std::function<void (bool)> &callback)
 {
-    if(!connectToService())
-        return false;
-
-    QDBusReply<int> reply = bioService->call("CheckAppApiVersion",
-                                             APP_API_MAJOR,
-                                             APP_API_MINOR,
-                                             APP_API_FUNC);
-    if(!reply.isValid())
-    {
-        qDebug() << "check api compatibility error: " << reply.error();
-        return false;
-    }
-    return (reply.value() == 0);
+    std::shared_ptr<ServiceWaiter> waiter = std::make_shared<ServiceWaiter>();
+    waiter->previousOwner = previousOwner;
+    waiter->callback = callback;
+    waiter->elapsed.start();
+
+    waiter->retryTimer = new QTimer(this);
+    waiter->retryTimer->setSingleShot(true);
+    connect(waiter->retryTimer, &QTimer::timeout, this, [this, waiter] {
+        probeService(waiter);
+    });
+
+    waiter->ownerConnection = connect(this, &ServiceManager::serviceStatusChanged,
+                                      this, [this, waiter](bool activate) {
+        if(!activate)
+            return;
+        waiter->retryTimer->stop();
+        waiter->backoff = SERVICE_PROBE_MIN;
+        probeService(waiter);
+    });
+
+    /* 探测调用本身可能一直得不到应答，单独计算期限 */
+    QTimer::singleShot(SERVICE_WAIT_TIMEOUT, this, [this, waiter] {
+        finishWaiting(waiter, false);
+    });
+
+    probeService(waiter);
+}
+
+void ServiceManager::probeService(const std::shared_ptr<ServiceWaiter> &waiter)
+{
+    if(waiter->finished || waiter->probing)
+        return;
+
+    waiter->probing = true;
+    QDBusPendingReply<int> reply =
+            BiometricProxy::instance()->CheckAppApiVersion(APP_API_MAJOR,
+                                                           APP_API_MINOR,
+                                                           APP_API_FUNC);
+    watchReply(reply, this, [this, waiter](const QDBusPendingReply<int> &reply) {
+        waiter->probing = false;
+        if(waiter->finished)
+            return;
+
+        bool restarted = waiter->previousOwner.isEmpty() ?
+                    waiter->elapsed.elapsed() >= SERVICE_RESTART_GRACE :
+                    owner != waiter->previousOwner;
+        if(!reply.isError() && !owner.isEmpty() && restarted) {
+            finishWaiting(waiter, true);
+            return;
+        }
+
+        waiter->retryTimer->start(waiter->backoff);
+        waiter->backoff = qMin(waiter->backoff * 2, SERVICE_PROBE_MAX);
+    });
+}
+
+void ServiceManager::finishWaiting(const std::shared_ptr<ServiceWaiter> &waiter, bool ready)
+{
+    if(waiter->finished)
+        return;
+
+    waiter->finished = true;
+    disconnect(waiter->ownerConnection);
+    waiter->retryTimer->stop();
+    waiter->retryTimer->deleteLater();
+
+    qDebug() << "service" << (ready ? "is ready after" : "is not ready after")
+             << waiter->elapsed.elapsed() << "ms";
+    waiter->callback(ready);
 }
@@ -20,23 +20,38 @@
 #define SERVICEMANAGER_H
 
 #include <QObject>
-#include <QDBusInterface>
+#include <QDBusConnectionInterface>
+#include <functional>
+#include <memory>
 
 class ServiceManager : public QObject
 {
     Q_OBJECT
 public:
+    enum CheckResult {
+        ServiceReady,
+        ServiceNotStarted,
+        ApiNotCompatible
+    };
+    Q_ENUM(CheckResult)
+
     static ServiceManager *instance();
-    bool serviceExists();
-    bool apiCompatible();
+    void checkService();
+    QString serviceOwner() const;
+    void waitForService(const QString &previousOwner,
+                        const std::function<void (bool)> &callback);
 
 private:
+    struct ServiceWaiter;
+
     explicit ServiceManager(QObject *parent = nullptr);
     void init();
-    bool connectToService();
+    void probeService(const std::shared_ptr<ServiceWaiter> &waiter);
+    void finishWaiting(const std::shared_ptr<ServiceWaiter> &waiter, bool ready);
 
 signals:
     void serviceStatusChanged(bool activate);
+    void serviceChecked(ServiceManager::CheckResult result);
 
 public slots:
     void onDBusNameOwnerChanged(const QString &name,
@@ -45,9 +60,9 @@ public slots:
 
 private:
     static ServiceManager   *instance_;
-    QDBusInterface          *dbusService;
-    QDBusInterface          *bioService;
+    QDBusConnectionInterface *dbusService;
     bool                    serviceStatus;
+    QString                 owner;      //服务当前的唯一连接名
 };
 
 #endif // SERVICEMANAGER_H
@@ -17,19 +17,30 @@
 **/
 #include "treemodel.h"
 #include <QDebug>
-#include <pwd.h>
+#include <QSet>
+#include <algorithm>
+#include "usernameresolver.h"
+
+#define FEATURE_PAGE_SIZE 50
 
 TreeModel::TreeModel(int uid, BioType type, QObject *parent)
     : QAbstractItemModel(parent),
       rootItem(nullptr),
       uid_(uid),
-      type_(type)
+      type_(type),
+      fetchStart(0),
+      fetching(false),
+      fetchTail(false),
+      fetchDone(true)
 {
     QString typeText = EnumToString::transferBioType(type_) + tr("Name");
     if(isAdmin(uid))
         rootItem = new TreeItem({"    " + tr("index"), tr("username"), typeText});
     else
         rootItem = new TreeItem({"    " + tr("index"), typeText});
+
+    connect(UserNameResolver::instance(), &UserNameResolver::userNamesResolved,
+            this, &TreeModel::onUserNamesResolved);
 }
 
 TreeModel::~TreeModel()
@@ -80,6 +91,12 @@ QVariant TreeModel::data(const QModelIndex &index, int role) const
 
     switch(role) {
     case Qt::DisplayRole:
+        /* 管理员模式的用户名列，未解析完成时先显示 uid */
+        if(isAdmin(uid_) && index.column() == 1 && item->parent() == rootItem)
+            return UserNameResolver::instance()->userName(item->getUid());
+        /* 序号由行号得出，增删行后不需要逐行更新 */
+        if(index.column() == 0 && item->parent() == rootItem)
+            return QString::number(index.row() + 1);
         return item->data(index.column());
     case Qt::UserRole:
         return item->getIndex();
@@ -95,6 +112,20 @@ QVariant TreeModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
+void TreeModel::onUserNamesResolved(const QList<int> &uids)
+{
+    if(!isAdmin(uid_))
+        return;
+
+    for(int uid : uids) {
+        TreeItem *item = parentItems.value(uid);
+        if(!item || item == rootItem)
+            continue;
+        QModelIndex nameIndex = createIndex(item->row(), 1, item);
+        Q_EMIT dataChanged(nameIndex, nameIndex, {Qt::DisplayRole});
+    }
+}
+
 QModelIndex TreeModel::index(int row, int column, const QModelIndex &parent) const
 {
     if (!hasIndex(row, column, parent))
@@ -186,12 +217,6 @@ void TreeModel::setupTestData()
     rootItem->appendChild(user3);
 }
 
-QString getUserName(uid_t uid)
-{
-    struct passwd *pwd = getpwuid(uid);
-    return QString(pwd->pw_name);
-}
-
 void TreeModel::setModelData(const QList<FeatureInfo *> &featureInfoList)
 {
     if(featureInfoList.size() <= 0)
@@ -214,9 +239,8 @@ void TreeModel::setModelData(const QList<FeatureInfo *> &featureInfoList)
                 parentItems[featureInfo->uid]->appendChild(childItem);
             } else {
                 QString index = QString::number(parentItems.size() + 1);
-                QString userName = getUserName(featureInfo->uid);
                 TreeItem *parentItem = new TreeItem({index,
-                                                     userName,
+                                                     "",
                                                      featureInfo->index_name},
                                                     rootItem,
                                                     featureInfo->uid,
@@ -254,8 +278,9 @@ TreeItem *TreeModel::createItem(int serialNum,
                             featureInfo->index);
         break;
     case ADMIN_PARENT:
+        /* 用户名由 data() 通过 UserNameResolver 获取 */
         item = new TreeItem({QString::number(serialNum),
-                             getUserName(uid),
+                             "",
                              featureInfo->index_name},
                             rootItem,
                             uid,
@@ -278,16 +303,10 @@ void TreeModel::appendData(const FeatureInfo *featureInfo)
     if(isAdmin(uid_)) {
         //先判断该用户是否已经存在录入的特征
         int uid = featureInfo->uid;
-        QString userName = getUserName(uid);
 
         if(parentItems.contains(uid)) {
 
-            int row = -1;
-            for(int i = 0; i < rowCount(); i++) {
-                if(index(i, 1).data().toString() == userName) {
-                    row = i;
-                }
-            }
+            int row = parentItems[uid]->row();
 
             if(row >= 0) {  //已经有录入的特征
                 QModelIndex parent = index(row, 0);
@@ -322,21 +341,213 @@ void TreeModel::appendData(const FeatureInfo *featureInfo)
     }
 }
 
+/**
+ * @brief 批量追加特征
+ *
+ * 一次遍历按 uid 分组。模型为空时用一次 reset 发布，已有数据时（分页加载的后续页）
+ * 新用户的行和已有用户新增的子节点各自一次插入，不影响视图的展开状态和滚动位置。
+ */
+void TreeModel::appendFeatures(const QVector<FeatureInfo> &unsortedList)
+{
+    if(unsortedList.isEmpty())
+        return;
+
+    /* 保持每个用户的特征按索引升序，syncFeatures 依赖这个顺序 */
+    QVector<FeatureInfo> featureList = unsortedList;
+    std::stable_sort(featureList.begin(), featureList.end(),
+                     [](const FeatureInfo &a, const FeatureInfo &b) {
+        return a.uid < b.uid || (a.uid == b.uid && a.index < b.index);
+    });
+
+    int firstRow = rootItem->childCount();
+    bool reset = (firstRow == 0);
+    QList<TreeItem*> topItems;
+    QSet<int> newUids;
+    /* 已在模型中的父节点 -> 新增的子节点 */
+    QList<TreeItem*> grownParents;
+    QHash<TreeItem*, QList<TreeItem*>> newChildren;
+
+    if(!isAdmin(uid_) && parentItems.isEmpty())
+        parentItems[uid_] = rootItem;
+
+    for(const FeatureInfo &featureInfo : featureList) {
+        if(!isAdmin(uid_)) {
+            topItems.append(createItem(firstRow + topItems.size() + 1, &featureInfo, NORMAL));
+            continue;
+        }
+
+        int uid = featureInfo.uid;
+        TreeItem *parentItem = parentItems.value(uid);
+        if(!parentItem) {
+            parentItem = createItem(firstRow + topItems.size() + 1, &featureInfo, ADMIN_PARENT);
+            parentItems[uid] = parentItem;
+            newUids.insert(uid);
+            topItems.append(parentItem);
+        } else if(newUids.contains(uid)) {
+            parentItem->appendChild(createItem(0, &featureInfo, ADMIN_CHILD));
+        } else {
+            if(!newChildren.contains(parentItem))
+                grownParents.append(parentItem);
+            newChildren[parentItem].append(createItem(0, &featureInfo, ADMIN_CHILD));
+        }
+    }
+
+    if(reset) {
+        beginResetModel();
+        for(TreeItem *item : topItems)
+            rootItem->appendChild(item);
+        endResetModel();
+        return;
+    }
+
+    if(!topItems.isEmpty()) {
+        beginInsertRows(QModelIndex(), firstRow, firstRow + topItems.size() - 1);
+        for(TreeItem *item : topItems)
+            rootItem->appendChild(item);
+        endInsertRows();
+    }
+
+    for(TreeItem *parentItem : grownParents) {
+        const QList<TreeItem*> &items = newChildren[parentItem];
+        int count = parentItem->childCount();
+        beginInsertRows(createIndex(parentItem->row(), 0, parentItem),
+                        count, count + items.size() - 1);
+        for(TreeItem *item : items)
+            parentItem->appendChild(item);
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief 用新的特征列表更新模型
+ *
+ * 以 (uid, index) 为键和当前的内容比较，只对删除、新增和改名的特征发出通知，
+ * 视图的选中和展开状态得以保留。新列表应覆盖模型中已加载的索引范围。
+ */
+void TreeModel::syncFeatures(const QVector<FeatureInfo> &featureList)
+{
+    if(featureList.isEmpty()) {
+        int count = rootItem->childCount();
+        if(count > 0) {
+            beginRemoveRows(QModelIndex(), 0, count - 1);
+            rootItem->cleanChildren();
+            endRemoveRows();
+        }
+        parentItems.clear();
+        return;
+    }
+
+    /* uid -> 按索引排序的特征 */
+    QHash<int, QVector<const FeatureInfo*>> groups;
+    QList<int> uidOrder;
+    for(const FeatureInfo &featureInfo : featureList) {
+        if(!groups.contains(featureInfo.uid))
+            uidOrder.append(featureInfo.uid);
+        groups[featureInfo.uid].append(&featureInfo);
+    }
+    for(auto &group : groups)
+        std::stable_sort(group.begin(), group.end(),
+                         [](const FeatureInfo *a, const FeatureInfo *b) {
+            return a->index < b->index;
+        });
+
+    if(!isAdmin(uid_)) {
+        if(parentItems.isEmpty())
+            parentItems[uid_] = rootItem;
+        syncChildren(rootItem, QModelIndex(), groups.value(uid_), NORMAL);
+        return;
+    }
+
+    /* 删除已经没有特征的用户 */
+    for(int row = rootItem->childCount() - 1; row >= 0; row--) {
+        int uid = rootItem->child(row)->getUid();
+        if(groups.contains(uid))
+            continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        rootItem->removeChild(row, true);
+        endRemoveRows();
+        parentItems.remove(uid);
+    }
+
+    /* 更新已有的用户，父节点显示该用户索引最小的特征，其余为子节点 */
+    QList<TreeItem*> newItems;
+    for(int uid : uidOrder) {
+        const QVector<const FeatureInfo*> &group = groups[uid];
+        TreeItem *parentItem = parentItems.value(uid);
+        if(!parentItem) {
+            parentItem = createItem(0, group[0], ADMIN_PARENT);
+            parentItems[uid] = parentItem;
+            for(int i = 1; i < group.size(); i++)
+                parentItem->appendChild(createItem(0, group[i], ADMIN_CHILD));
+            newItems.append(parentItem);
+            continue;
+        }
+
+        int row = parentItem->row();
+        if(parentItem->getIndex() != group[0]->index ||
+                parentItem->data(2).toString() != group[0]->index_name) {
+            parentItem->setIndex(group[0]->index);
+            parentItem->setData(2, group[0]->index_name);
+            Q_EMIT dataChanged(index(row, 2), index(row, 2));
+        }
+        syncChildren(parentItem, index(row, 0), group.mid(1), ADMIN_CHILD);
+    }
+
+    if(!newItems.isEmpty()) {
+        int first = rootItem->childCount();
+        beginInsertRows(QModelIndex(), first, first + newItems.size() - 1);
+        for(TreeItem *item : newItems)
+            rootItem->appendChild(item);
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief 把 parentItem 的子节点更新为 target，两者都按索引升序
+ */
+void TreeModel::syncChildren(TreeItem *parentItem, const QModelIndex &parent,
+                             const QVector<const FeatureInfo*> &target, int type)
+{
+    int nameColumn = (type == NORMAL) ? 1 : 2;
+    QSet<int> targetIndexes;
+    for(const FeatureInfo *featureInfo : target)
+        targetIndexes.insert(featureInfo->index);
+
+    for(int row = parentItem->childCount() - 1; row >= 0; row--) {
+        if(targetIndexes.contains(parentItem->child(row)->getIndex()))
+            continue;
+        beginRemoveRows(parent, row, row);
+        parentItem->removeChild(row, true);
+        endRemoveRows();
+    }
+
+    int row = 0;
+    for(const FeatureInfo *featureInfo : target) {
+        TreeItem *child = parentItem->child(row);
+        if(child && child->getIndex() == featureInfo->index) {
+            if(child->data(nameColumn).toString() != featureInfo->index_name) {
+                child->setData(nameColumn, featureInfo->index_name);
+                QModelIndex nameIndex = index(row, nameColumn, parent);
+                Q_EMIT dataChanged(nameIndex, nameIndex);
+            }
+        } else {
+            beginInsertRows(parent, row, row);
+            parentItem->insertChild(row, createItem(row + 1, featureInfo, type));
+            endInsertRows();
+        }
+        row++;
+    }
+}
+
 void TreeModel::insertData(const FeatureInfo *featureInfo)
 {
     if(isAdmin(uid_)){
 
         int uid = featureInfo->uid;
-        QString userName = getUserName(uid);
 
         if(parentItems.contains(uid)) {
 
-            int row = -1;
-            for(int i = 0; i < rowCount(); i++) {
-                if(index(i, 1).data().toString() == userName) {
-                    row = i;
-                }
-            }
+            int row = parentItems[uid]->row();
             TreeItem *parentItem = parentItems[uid];
             QModelIndex parent = index(row, 0);
             if(parentItem->getIndex() > featureInfo->index) {   //成为父节点
@@ -345,7 +556,6 @@ void TreeModel::insertData(const FeatureInfo *featureInfo)
                                                    parentItem->getUid(),
                                                    parentItem->getIndex());
                 parentItem->setData(0, row + 1);
-                parentItem->setData(1, userName);
                 parentItem->setData(2, featureInfo->index_name);
                 parentItem->setIndex(featureInfo->index);
                 parentItem->setUid(featureInfo->uid);
@@ -423,11 +633,97 @@ void TreeModel::removeAll()
 {
     int count = rowCount(QModelIndex());
 
-    beginRemoveRows(QModelIndex(), 0, count - 1);
-    rootItem->cleanChildren();
-    endRemoveRows();
+    if(count > 0) {
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+        rootItem->cleanChildren();
+        endRemoveRows();
+    }
 
     parentItems.clear();
+    fetching = false;
+    fetchDone = true;
+}
+
+/*!
+ * \brief TreeModel::resetFetch
+ * 从索引 0 开始重新分页加载，调用前应先 removeAll
+ */
+void TreeModel::resetFetch()
+{
+    fetchStart = 0;
+    fetching = false;
+    fetchTail = false;
+    fetchDone = false;
+}
+
+/*!
+ * \brief TreeModel::fetchRemaining
+ * 不再分页，下一次请求取出剩余的所有特征（录入、重命名前需要完整的列表）
+ */
+void TreeModel::fetchRemaining()
+{
+    fetchTail = true;
+    if(canFetchMore(QModelIndex()))
+        fetchMore(QModelIndex());
+}
+
+/*!
+ * \brief TreeModel::finishFetch
+ * \param count 本页返回的特征数，小于 0 表示查询失败，停止加载
+ * 索引可能不连续，遇到空页时不能断定已经结束，改为一次取出剩余部分
+ */
+void TreeModel::finishFetch(int count)
+{
+    fetching = false;
+    if(count < 0 || fetchTail) {
+        fetchDone = true;
+        return;
+    }
+    fetchStart += FEATURE_PAGE_SIZE;
+    if(count == 0)
+        fetchTail = true;
+}
+
+/*!
+ * \brief TreeModel::cancelFetch
+ * 放弃正在等待的一页（例如设备被拔出），已加载的范围不变
+ */
+void TreeModel::cancelFetch()
+{
+    fetching = false;
+}
+
+/*!
+ * \brief TreeModel::loadedIndexEnd
+ * \return 已加载的索引范围的终点，-1 表示已全部加载
+ */
+int TreeModel::loadedIndexEnd() const
+{
+    return fetchDone ? -1 : fetchStart - 1;
+}
+
+bool TreeModel::isFetching() const
+{
+    return fetching;
+}
+
+bool TreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return false;
+    return !fetchDone && !fetching;
+}
+
+void TreeModel::fetchMore(const QModelIndex &parent)
+{
+    if(!canFetchMore(parent))
+        return;
+
+    fetching = true;
+    if(fetchTail)
+        Q_EMIT fetchRequested(fetchStart, -1);
+    else
+        Q_EMIT fetchRequested(fetchStart, fetchStart + FEATURE_PAGE_SIZE - 1);
 }
 
 void TreeModel::updateSerialNum()
@@ -37,6 +37,8 @@ public:
 
     void setModelData(const QList<FeatureInfo*> &featureInfoList);
     void appendData(const FeatureInfo* featureInfo);
+    void appendFeatures(const QVector<FeatureInfo> &featureList);
+    void syncFeatures(const QVector<FeatureInfo> &featureList);
     void insertData(const FeatureInfo *featureInfo);
     int findInsertPosition(const FeatureInfo* featureInfo, TreeItem *parentItem);
     bool removeRow(int row, const QModelIndex &parent=QModelIndex(), bool recursive=false);
@@ -47,6 +49,14 @@ public:
     bool hasFeature(int uid, const QString &featureName);
     TreeItem *createItem(int serialNum, const FeatureInfo *featureInfo, int type);
 
+    /* 分页加载，每页是特征索引的一段区间 */
+    void resetFetch();
+    void fetchRemaining();
+    void finishFetch(int count);
+    void cancelFetch();
+    bool isFetching() const;
+    int loadedIndexEnd() const;
+
 public:
     int columnCount(const QModelIndex &parent) const;
     int rowCount(const QModelIndex &parent=QModelIndex()) const;
@@ -57,13 +67,29 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role) const;
     QHash<int, QByteArray> roleNames() const;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+
+signals:
+    void fetchRequested(int idxStart, int idxEnd);
+
+private slots:
+    void onUserNamesResolved(const QList<int> &uids);
+
+private:
+    void syncChildren(TreeItem *parentItem, const QModelIndex &parent,
+                      const QVector<const FeatureInfo*> &target, int type);
 
 private:
     enum ItemType{NORMAL, ADMIN_PARENT, ADMIN_CHILD};
     TreeItem *rootItem;
-    QMap<int, TreeItem*> parentItems;
+    QHash<int, TreeItem*> parentItems;     //uid -> 该用户的第一行
     int uid_;   //当前用户id
     BioType type_;
+    int fetchStart;     //下一页的起始索引
+    bool fetching;      //正在等待一页数据
+    bool fetchTail;     //下一次取出剩余的所有特征
+    bool fetchDone;
 };
 
 #endif // TREEMODEL_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "usernameresolver.h"
+#include <QtConcurrent>
+#include <QDateTime>
+#include <QTimer>
+#include <errno.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#define USER_NAME_TTL (5 * 60 * 1000)   /* 毫秒 */
+
+UserNameResolver *UserNameResolver::instance_ = nullptr;
+
+UserNameResolver::UserNameResolver(QObject *parent)
+    : QObject(parent),
+      lookupScheduled(false),
+      watcher(new QFutureWatcher<NameTable>(this))
+{
+    connect(watcher, &QFutureWatcher<NameTable>::finished,
+            this, &UserNameResolver::onLookupFinished);
+}
+
+UserNameResolver *UserNameResolver::instance()
+{
+    if(!instance_)
+    {
+        instance_ = new UserNameResolver;
+    }
+    return instance_;
+}
+
+/**
+ * @brief 获取用户名
+ * 缓存中没有时返回 uid 作为占位；缓存过期时先返回旧值，同时在后台刷新
+ */
+QString UserNameResolver::userName(int uid)
+{
+    auto iter = cache.constFind(uid);
+    if(iter != cache.constEnd()) {
+        if(iter->expiry < QDateTime::currentMSecsSinceEpoch())
+            requestLookup(uid);
+        return iter->name;
+    }
+
+    requestLookup(uid);
+    return QString::number(uid);
+}
+
+void UserNameResolver::requestLookup(int uid)
+{
+    if(pending.contains(uid) || inFlight.contains(uid))
+        return;
+
+    pending.insert(uid);
+    /* 同一轮事件循环内的请求合并为一批 */
+    if(!lookupScheduled) {
+        lookupScheduled = true;
+        QTimer::singleShot(0, this, &UserNameResolver::startLookup);
+    }
+}
+
+void UserNameResolver::startLookup()
+{
+    lookupScheduled = false;
+    if(watcher->isRunning() || pending.isEmpty())
+        return;
+
+    inFlight = pending;
+    pending.clear();
+    watcher->setFuture(QtConcurrent::run(&UserNameResolver::lookup, inFlight.toList()));
+}
+
+void UserNameResolver::onLookupFinished()
+{
+    NameTable names = watcher->result();
+    qint64 expiry = QDateTime::currentMSecsSinceEpoch() + USER_NAME_TTL;
+    QList<int> changed;
+
+    for(auto iter = names.constBegin(); iter != names.constEnd(); ++iter) {
+        int uid = iter.key();
+        /* 查不到的用户继续显示 uid */
+        QString name = iter.value().isEmpty() ? QString::number(uid) : iter.value();
+        QString oldName = cache.contains(uid) ? cache[uid].name : QString::number(uid);
+        if(name != oldName)
+            changed.append(uid);
+        cache[uid] = CacheEntry{name, expiry};
+    }
+    inFlight.clear();
+
+    if(!changed.isEmpty())
+        Q_EMIT userNamesResolved(changed);
+
+    if(!pending.isEmpty())
+        startLookup();
+}
+
+/**
+ * @brief 在工作线程中查询，getpwuid 不可重入，这里使用 getpwuid_r
+ */
+UserNameResolver::NameTable UserNameResolver::lookup(const QList<int> &uids)
+{
+    NameTable names;
+    long size = sysconf(_SC_GETPW_R_SIZE_MAX);
+    QByteArray buffer(size > 0 ? size : 16384, 0);
+
+    for(int uid : uids) {
+        struct passwd pwd;
+        struct passwd *result = nullptr;
+        int ret;
+        while((ret = getpwuid_r(uid, &pwd, buffer.data(), buffer.size(), &result)) == ERANGE)
+            buffer.resize(buffer.size() * 2);
+
+        if(ret == 0 && result && result->pw_name)
+            names.insert(uid, QString::fromLocal8Bit(result->pw_name));
+        else
+            names.insert(uid, QString());
+    }
+    return names;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef USERNAMERESOLVER_H
+#define USERNAMERESOLVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QFutureWatcher>
+
+/**
+ * @brief uid 到用户名的解析
+ *
+ * 在 SSSD/LDAP 环境中 getpwuid 可能很慢，这里把查询放到工作线程中批量进行，
+ * 结果缓存一段时间。未解析完成时返回 uid 作为占位，解析完成后发出 userNamesResolved。
+ */
+class UserNameResolver : public QObject
+{
+    Q_OBJECT
+private:
+    explicit UserNameResolver(QObject *parent = nullptr);
+    UserNameResolver(const UserNameResolver &resolver) = delete;
+    UserNameResolver& operator =(const UserNameResolver &rhs) = delete;
+
+public:
+    typedef QHash<int, QString> NameTable;
+
+    static UserNameResolver *instance();
+    QString userName(int uid);
+
+signals:
+    void userNamesResolved(const QList<int> &uids);
+
+private:
+    void requestLookup(int uid);
+    void startLookup();
+    void onLookupFinished();
+    static NameTable lookup(const QList<int> &uids);
+
+private:
+    struct CacheEntry {
+        QString name;
+        qint64 expiry;
+    };
+    static UserNameResolver *instance_;
+    QHash<int, CacheEntry> cache;
+    QSet<int> pending;      //等待下一批查询
+    QSet<int> inFlight;     //正在查询
+    bool lookupScheduled;
+    QFutureWatcher<NameTable> *watcher;
+};
+
+#endif // USERNAMERESOLVER_H
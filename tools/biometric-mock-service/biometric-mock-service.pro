@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Stand-in org.ukui.Biometric service used to exercise
+# biometric-manager without real devices.
+#
+#-------------------------------------------------
+
+QT       += core dbus
+QT       -= gui
+
+TARGET = biometric-mock-service
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../../src
+
+SOURCES += main.cpp \
+    mockservice.cpp \
+    ../../src/customtype.cpp
+
+HEADERS += mockservice.h \
+    ../../src/customtype.h
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <QDebug>
+#include <unistd.h>
+#include "mockservice.h"
+
+/*
+ * 用法示例（会话总线）：
+ *   biometric-mock-service --devices 8 --features 20 --uids 0,1000 \
+ *       --latency 30 --method-latency GetFeatureList=300 --storm 6:5:2000
+ *   BIOMETRIC_DBUS_BUS=session biometric-manager
+ */
+
+static bool parseOptions(QCoreApplication &app, MockOptions &options, QString &bus)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Stand-in org.ukui.Biometric service");
+    parser.addHelpOption();
+
+    QCommandLineOption busOption("bus", "session (default), system, or a D-Bus address.",
+                                 "bus", "session");
+    QCommandLineOption devicesOption("devices", "Number of devices.", "count", "4");
+    QCommandLineOption featuresOption("features", "Features per user per device.", "count", "5");
+    QCommandLineOption uidsOption("uids", "Comma separated uids owning features.", "uids",
+                                  QString::number(getuid()));
+    QCommandLineOption latencyOption("latency", "Default reply latency of every method.",
+                                     "ms", "0");
+    QCommandLineOption methodLatencyOption("method-latency",
+                                           "Per method latency, e.g. GetFeatureList=200,Clean=50.",
+                                           "list");
+    QCommandLineOption notifyOption("enroll-notify", "StatusChanged signals sent per enroll.",
+                                    "count", "5");
+    QCommandLineOption incompatibleOption("api-incompatible",
+                                          "Report an incompatible API version.");
+    QCommandLineOption stormOption("storm",
+                                   "Hotplug storm: events[:interval ms[:period ms]].",
+                                   "spec");
+    parser.addOptions({busOption, devicesOption, featuresOption, uidsOption,
+                       latencyOption, methodLatencyOption, notifyOption,
+                       incompatibleOption, stormOption});
+    parser.process(app);
+
+    bus = parser.value(busOption);
+    options.deviceCount = parser.value(devicesOption).toInt();
+    options.featureCount = parser.value(featuresOption).toInt();
+    for(const QString &uid : parser.value(uidsOption).split(',', QString::SkipEmptyParts))
+        options.uids.append(uid.toInt());
+    options.latency = parser.value(latencyOption).toInt();
+    for(const QString &item : parser.value(methodLatencyOption).split(',', QString::SkipEmptyParts)) {
+        QStringList pair = item.split('=');
+        if(pair.size() != 2) {
+            qWarning() << "invalid method latency:" << item;
+            return false;
+        }
+        options.methodLatency.insert(pair[0].trimmed(), pair[1].toInt());
+    }
+    options.enrollNotifyCount = parser.value(notifyOption).toInt();
+    options.apiCompatible = !parser.isSet(incompatibleOption);
+
+    QStringList storm = parser.value(stormOption).split(':', QString::SkipEmptyParts);
+    if(storm.size() > 0)
+        options.stormSize = storm[0].toInt();
+    if(storm.size() > 1)
+        options.stormInterval = storm[1].toInt();
+    if(storm.size() > 2)
+        options.stormPeriod = storm[2].toInt();
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("biometric-mock-service");
+
+    MockOptions options;
+    QString bus;
+    if(!parseOptions(app, options, bus))
+        return EXIT_FAILURE;
+
+    QDBusConnection connection = QDBusConnection::sessionBus();
+    if(bus == "system")
+        connection = QDBusConnection::systemBus();
+    else if(bus != "session")
+        connection = QDBusConnection::connectToBus(bus, "biometric-mock");
+
+    if(!connection.isConnected()) {
+        qWarning() << "cannot connect to bus" << bus << connection.lastError().message();
+        return EXIT_FAILURE;
+    }
+
+    MockService service(options);
+    if(!connection.registerObject(DBUS_PATH, &service,
+                                  QDBusConnection::ExportAllSlots |
+                                  QDBusConnection::ExportAllSignals)) {
+        qWarning() << "cannot register object:" << connection.lastError().message();
+        return EXIT_FAILURE;
+    }
+    if(!connection.registerService(DBUS_SERVICE)) {
+        qWarning() << "cannot register service:" << connection.lastError().message();
+        return EXIT_FAILURE;
+    }
+
+    qDebug() << "serving" << DBUS_SERVICE << "on" << bus << "with"
+             << options.deviceCount << "devices," << options.featureCount
+             << "features per user for uids" << options.uids;
+
+    QTimer::singleShot(0, &service, &MockService::startHotplugStorm);
+
+    return app.exec();
+}
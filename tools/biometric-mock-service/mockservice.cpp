@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include "mockservice.h"
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+#define DEVICE_ID_BASE      100
+#define DEV_STATUS_IDLE     0
+#define DEV_STATUS_ENROLL   201
+
+static const int mockBioTypes[] = {
+    BIOTYPE_FINGERPRINT,
+    BIOTYPE_FINGERVEIN,
+    BIOTYPE_IRIS,
+    BIOTYPE_VOICEPRINT
+};
+
+MockService::MockService(const MockOptions &options, QObject *parent)
+    : QObject(parent),
+      options(options),
+      stormCursor(0)
+{
+    registerCustomTypes();
+    initDevices();
+    initFeatures();
+}
+
+void MockService::initDevices()
+{
+    for(int i = 0; i < options.deviceCount; i++) {
+        DeviceInfo deviceInfo;
+        deviceInfo.device_id = DEVICE_ID_BASE + i;
+        deviceInfo.biotype = mockBioTypes[i % 4];
+        deviceInfo.device_shortname = QString("mock_%1_%2").arg(deviceInfo.biotype).arg(i);
+        deviceInfo.device_fullname = QString("Mock %1 Device %2")
+                .arg(EnumToString::transferBioType(deviceInfo.biotype)).arg(i);
+        deviceInfo.driver_enable = 1;
+        deviceInfo.device_available = 1;
+        deviceInfo.stotype = STORAGE_OS;
+        deviceInfo.eigtype = 0;
+        deviceInfo.vertype = VERIFY_SOFTWARE;
+        deviceInfo.idtype = IDENTIFY_SOFTWARE;
+        deviceInfo.bustype = BUS_USB;
+        deviceInfo.dev_status = DEV_STATUS_IDLE;
+        deviceInfo.ops_status = OPS_SUCCESS;
+        devices.append(deviceInfo);
+    }
+}
+
+void MockService::initFeatures()
+{
+    for(const DeviceInfo &deviceInfo : devices) {
+        QList<FeatureInfo> &featureList = featureStore[deviceInfo.device_id];
+        for(int uid : options.uids) {
+            for(int idx = 1; idx <= options.featureCount; idx++) {
+                FeatureInfo featureInfo;
+                featureInfo.uid = uid;
+                featureInfo.biotype = deviceInfo.biotype;
+                featureInfo.device_shortname = deviceInfo.device_shortname;
+                featureInfo.index = idx;
+                featureInfo.index_name = QString("feature%1").arg(idx);
+                featureList.append(featureInfo);
+            }
+        }
+    }
+}
+
+DeviceInfo *MockService::findDevice(int drvid)
+{
+    for(DeviceInfo &deviceInfo : devices)
+        if(deviceInfo.device_id == drvid)
+            return &deviceInfo;
+    return nullptr;
+}
+
+/**
+ * @brief 按 uid（-1 表示所有用户）和索引范围（idxEnd 为 -1 表示到末尾）筛选特征
+ */
+QList<FeatureInfo> MockService::features(int drvid, int uid, int idxStart, int idxEnd)
+{
+    QList<FeatureInfo> result;
+    for(const FeatureInfo &featureInfo : featureStore.value(drvid)) {
+        if(uid != -1 && featureInfo.uid != uid)
+            continue;
+        if(featureInfo.index < idxStart)
+            continue;
+        if(idxEnd >= 0 && featureInfo.index > idxEnd)
+            continue;
+        result.append(featureInfo);
+    }
+    return result;
+}
+
+/**
+ * @brief 按方法配置的延迟发送应答，延迟期间不阻塞其它调用
+ */
+void MockService::sendReply(const QList<QVariant> &arguments)
+{
+    QString method = message().member();
+    int delay = options.methodLatency.value(method, options.latency);
+    QDBusMessage reply = message().createReply(arguments);
+    QDBusConnection conn = connection();
+
+    setDelayedReply(true);
+    if(delay <= 0) {
+        conn.send(reply);
+        return;
+    }
+    QTimer::singleShot(delay, this, [conn, reply]{ conn.send(reply); });
+}
+
+int MockService::GetDrvList(QList<QDBusVariant> &deviceList)
+{
+    deviceList.clear();
+    for(const DeviceInfo &deviceInfo : devices)
+        deviceList.append(QDBusVariant(QVariant::fromValue(deviceInfo)));
+
+    sendReply({devices.size(), QVariant::fromValue(deviceList)});
+    return devices.size();
+}
+
+int MockService::GetFeatureList(int drvid, int uid, int idxStart, int idxEnd,
+                                QList<QDBusVariant> &featureList)
+{
+    featureList.clear();
+    if(!findDevice(drvid)) {
+        sendReply({DBUS_RESULT_NOSUCHDEVICE, QVariant::fromValue(featureList)});
+        return DBUS_RESULT_NOSUCHDEVICE;
+    }
+
+    for(const FeatureInfo &featureInfo : features(drvid, uid, idxStart, idxEnd))
+        featureList.append(QDBusVariant(QVariant::fromValue(featureInfo)));
+
+    sendReply({featureList.size(), QVariant::fromValue(featureList)});
+    return featureList.size();
+}
+
+int MockService::Enroll(int drvid, int uid, int idx, const QString &idxName)
+{
+    DeviceInfo *deviceInfo = findDevice(drvid);
+    if(!deviceInfo || deviceInfo->device_available <= 0) {
+        sendReply({DBUS_RESULT_NOSUCHDEVICE});
+        return DBUS_RESULT_NOSUCHDEVICE;
+    }
+    if(deviceInfo->dev_status != DEV_STATUS_IDLE) {
+        sendReply({DBUS_RESULT_DEVICEBUSY});
+        return DBUS_RESULT_DEVICEBUSY;
+    }
+
+    FeatureInfo featureInfo;
+    featureInfo.uid = uid;
+    featureInfo.biotype = deviceInfo->biotype;
+    featureInfo.device_shortname = deviceInfo->device_shortname;
+    featureInfo.index = idx;
+    featureInfo.index_name = idxName;
+
+    /* 在应答延迟内均匀地发出提示信息和进度 */
+    int duration = options.methodLatency.value("Enroll", options.latency);
+    int steps = qMax(options.enrollNotifyCount, 1);
+    deviceInfo->dev_status = DEV_STATUS_ENROLL;
+    for(int i = 1; i <= steps; i++) {
+        QTimer::singleShot(duration * i / (steps + 1), this, [this, drvid, i, steps]{
+            notifyMessages[drvid] = QString("Please press your finger (%1/%2)").arg(i).arg(steps);
+            Q_EMIT StatusChanged(drvid, STATUS_NOTIFY);
+            Q_EMIT ProcessChanged(drvid, "enroll", i * 100 / steps, "");
+        });
+    }
+    QTimer::singleShot(duration, this, [this, drvid, featureInfo]{
+        if(DeviceInfo *deviceInfo = findDevice(drvid))
+            deviceInfo->dev_status = DEV_STATUS_IDLE;
+        QList<FeatureInfo> &featureList = featureStore[drvid];
+        auto iter = std::find_if(featureList.begin(), featureList.end(),
+                                 [&](const FeatureInfo &info) {
+            return info.uid > featureInfo.uid ||
+                    (info.uid == featureInfo.uid && info.index > featureInfo.index);
+        });
+        featureList.insert(iter, featureInfo);
+    });
+
+    sendReply({DBUS_RESULT_SUCCESS});
+    return DBUS_RESULT_SUCCESS;
+}
+
+int MockService::Verify(int drvid, int uid, int idx)
+{
+    if(!findDevice(drvid)) {
+        sendReply({DBUS_RESULT_NOSUCHDEVICE});
+        return DBUS_RESULT_NOSUCHDEVICE;
+    }
+
+    int result = features(drvid, uid, idx, idx).isEmpty() ? DBUS_RESULT_NOTMATCH : idx;
+    sendReply({result});
+    return result;
+}
+
+int MockService::Search(int drvid, int uid, int idxStart, int idxEnd,
+                        QList<QDBusVariant> &searchResults)
+{
+    searchResults.clear();
+    if(!findDevice(drvid)) {
+        sendReply({DBUS_RESULT_NOSUCHDEVICE, QVariant::fromValue(searchResults)});
+        return DBUS_RESULT_NOSUCHDEVICE;
+    }
+
+    for(const FeatureInfo &featureInfo : features(drvid, uid, idxStart, idxEnd)) {
+        SearchResult ret;
+        ret.uid = featureInfo.uid;
+        ret.index = featureInfo.index;
+        ret.indexName = featureInfo.index_name;
+        searchResults.append(QDBusVariant(QVariant::fromValue(ret)));
+    }
+
+    int result = searchResults.isEmpty() ? DBUS_RESULT_NOTMATCH : searchResults.size();
+    sendReply({result, QVariant::fromValue(searchResults)});
+    return result;
+}
+
+int MockService::Clean(int drvid, int uid, int idxStart, int idxEnd)
+{
+    if(!findDevice(drvid)) {
+        sendReply({DBUS_RESULT_NOSUCHDEVICE});
+        return DBUS_RESULT_NOSUCHDEVICE;
+    }
+
+    QList<FeatureInfo> &featureList = featureStore[drvid];
+    for(int i = featureList.size() - 1; i >= 0; i--) {
+        const FeatureInfo &featureInfo = featureList[i];
+        if(uid != -1 && featureInfo.uid != uid)
+            continue;
+        if(featureInfo.index < idxStart || (idxEnd >= 0 && featureInfo.index > idxEnd))
+            continue;
+        featureList.removeAt(i);
+    }
+
+    sendReply({DBUS_RESULT_SUCCESS});
+    return DBUS_RESULT_SUCCESS;
+}
+
+int MockService::Rename(int drvid, int uid, int idx, const QString &newName)
+{
+    for(FeatureInfo &featureInfo : featureStore[drvid]) {
+        if(featureInfo.uid == uid && featureInfo.index == idx) {
+            featureInfo.index_name = newName;
+            sendReply({DBUS_RESULT_SUCCESS});
+            return DBUS_RESULT_SUCCESS;
+        }
+    }
+
+    notifyMessages[drvid] = QString("No feature %1 for uid %2").arg(idx).arg(uid);
+    sendReply({DBUS_RESULT_ERROR});
+    return DBUS_RESULT_ERROR;
+}
+
+int MockService::StopOps(int drvid, int waiting)
+{
+    UNUSED(waiting);
+    if(DeviceInfo *deviceInfo = findDevice(drvid))
+        deviceInfo->ops_status = OPS_CANCEL;
+
+    sendReply({DBUS_RESULT_SUCCESS});
+    return DBUS_RESULT_SUCCESS;
+}
+
+int MockService::UpdateStatus(int drvid, int &enable, int &devNum, int &devStatus,
+                              int &opsStatus, int &notifyMid)
+{
+    DeviceInfo *deviceInfo = findDevice(drvid);
+    int result = deviceInfo ? DBUS_RESULT_SUCCESS : DBUS_RESULT_NOSUCHDEVICE;
+    enable = deviceInfo ? deviceInfo->driver_enable : 0;
+    devNum = deviceInfo ? deviceInfo->device_available : 0;
+    devStatus = deviceInfo ? deviceInfo->dev_status : 0;
+    opsStatus = deviceInfo ? deviceInfo->ops_status : 0;
+    notifyMid = 0;
+
+    sendReply({result, enable, devNum, devStatus, opsStatus, notifyMid});
+    return result;
+}
+
+QString MockService::GetNotifyMesg(int drvid)
+{
+    QString text = notifyMessages.value(drvid);
+    sendReply({text});
+    return text;
+}
+
+QString MockService::GetOpsMesg(int drvid)
+{
+    QString text = opsMessages.value(drvid, QString("Mock operation failed"));
+    sendReply({text});
+    return text;
+}
+
+int MockService::CheckAppApiVersion(int major, int minor, int func)
+{
+    qDebug() << "CheckAppApiVersion" << major << minor << func;
+    int result = options.apiCompatible ? 0 : 1;
+    sendReply({result});
+    return result;
+}
+
+void MockService::startHotplugStorm()
+{
+    if(options.stormSize <= 0 || devices.isEmpty())
+        return;
+    emitStormEvent(options.stormSize);
+}
+
+/**
+ * @brief 轮流拔插设备，模拟 USB Hub 重新枚举时的信号风暴
+ */
+void MockService::emitStormEvent(int remaining)
+{
+    DeviceInfo &deviceInfo = devices[stormCursor++ % devices.size()];
+    deviceInfo.device_available = deviceInfo.device_available > 0 ? 0 : 1;
+    int action = deviceInfo.device_available > 0 ? 1 : -1;
+    Q_EMIT USBDeviceHotPlug(deviceInfo.device_id, action, deviceInfo.device_available);
+
+    if(remaining > 1) {
+        QTimer::singleShot(options.stormInterval, this, [this, remaining]{
+            emitStormEvent(remaining - 1);
+        });
+    } else if(options.stormPeriod > 0) {
+        QTimer::singleShot(options.stormPeriod, this, [this]{
+            emitStormEvent(options.stormSize);
+        });
+    }
+}
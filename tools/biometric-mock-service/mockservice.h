@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#ifndef MOCKSERVICE_H
+#define MOCKSERVICE_H
+
+#include <QObject>
+#include <QDBusContext>
+#include <QMap>
+#include <QHash>
+#include "customtype.h"
+
+/* 替身服务的可配置参数，由命令行解析得到 */
+struct MockOptions {
+    int deviceCount = 4;
+    int featureCount = 5;           /* 每个设备上每个用户的特征数 */
+    QList<int> uids;                /* 拥有特征的用户 */
+    int latency = 0;                /* 所有方法的默认延迟（毫秒）*/
+    QHash<QString, int> methodLatency;
+    int enrollNotifyCount = 5;      /* 录入过程中发出的 StatusChanged 次数 */
+    bool apiCompatible = true;
+    int stormSize = 0;              /* 每轮热插拔风暴的事件数 */
+    int stormInterval = 0;          /* 同一轮内事件的间隔（毫秒）*/
+    int stormPeriod = 0;            /* 两轮风暴之间的间隔（毫秒），0 表示只发一轮 */
+};
+
+/**
+ * @brief org.ukui.Biometric 的替身实现
+ *
+ * 在没有 biometric-authentication.service 和真实设备的环境中，
+ * 为界面的调试和性能测量提供可重复的数据与延迟。
+ */
+class MockService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.ukui.Biometric")
+public:
+    explicit MockService(const MockOptions &options, QObject *parent = nullptr);
+    void startHotplugStorm();
+
+public slots:
+    int GetDrvList(QList<QDBusVariant> &deviceList);
+    int GetFeatureList(int drvid, int uid, int idxStart, int idxEnd,
+                       QList<QDBusVariant> &featureList);
+    int Enroll(int drvid, int uid, int idx, const QString &idxName);
+    int Verify(int drvid, int uid, int idx);
+    int Search(int drvid, int uid, int idxStart, int idxEnd,
+               QList<QDBusVariant> &searchResults);
+    int Clean(int drvid, int uid, int idxStart, int idxEnd);
+    int Rename(int drvid, int uid, int idx, const QString &newName);
+    int StopOps(int drvid, int waiting);
+    int UpdateStatus(int drvid, int &enable, int &devNum, int &devStatus,
+                     int &opsStatus, int &notifyMid);
+    QString GetNotifyMesg(int drvid);
+    QString GetOpsMesg(int drvid);
+    int CheckAppApiVersion(int major, int minor, int func);
+
+signals:
+    void StatusChanged(int drvid, int status);
+    void ProcessChanged(int drvid, const QString &aa, int statusType, const QString &bb);
+    void USBDeviceHotPlug(int drvid, int action, int devNumNow);
+
+private:
+    void initDevices();
+    void initFeatures();
+    DeviceInfo *findDevice(int drvid);
+    QList<FeatureInfo> features(int drvid, int uid, int idxStart, int idxEnd);
+    void sendReply(const QList<QVariant> &arguments);
+    void emitStormEvent(int remaining);
+
+private:
+    MockOptions options;
+    QList<DeviceInfo> devices;
+    /* drvid -> 该设备上的特征，按 uid、index 排序 */
+    QMap<int, QList<FeatureInfo>> featureStore;
+    QHash<int, QString> notifyMessages;
+    QHash<int, QString> opsMessages;
+    int stormCursor;
+};
+
+#endif // MOCKSERVICE_H
@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Microbenchmark for decoding av replies of
+# org.ukui.Biometric into feature/device/search arrays.
+#
+#-------------------------------------------------
+
+QT       += core dbus
+QT       -= gui
+
+TARGET = decode-benchmark
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../../src
+
+SOURCES += main.cpp \
+    ../../src/customtype.cpp
+
+HEADERS += ../../src/customtype.h
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2018 Tianjin KYLIN Information Technology Co., Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+**/
+#include <QCoreApplication>
+#include <QDBusServer>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDir>
+#include <QDebug>
+#include <stdio.h>
+#include "customtype.h"
+
+/*
+ * 比较两种 av 应答的解码方式：
+ *   legacy -- QList<QDBusVariant> 中间容器 + 每个元素 new 一个结构体（原来的写法）
+ *   typed  -- decodeVariantArray 直接解码到 QVector
+ * 应答经过一条点对点 DBus 连接，保证解码的是真实的序列化数据。
+ */
+
+#define BENCH_PATH      "/org/ukui/Biometric/Benchmark"
+#define BENCH_INTERFACE "org.ukui.Biometric.Benchmark"
+
+class ListProvider : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", BENCH_INTERFACE)
+public slots:
+    int GetDrvList(int count, QList<QDBusVariant> &list)
+    {
+        for(int i = 0; i < count; i++) {
+            DeviceInfo deviceInfo;
+            deviceInfo.device_id = i;
+            deviceInfo.device_shortname = QString("device_%1").arg(i);
+            deviceInfo.device_fullname = QString("Benchmark Device %1").arg(i);
+            deviceInfo.driver_enable = 1;
+            deviceInfo.device_available = 1;
+            deviceInfo.biotype = i % 4;
+            deviceInfo.stotype = 0;
+            deviceInfo.eigtype = 0;
+            deviceInfo.vertype = 0;
+            deviceInfo.idtype = 0;
+            deviceInfo.bustype = 0;
+            deviceInfo.dev_status = 0;
+            deviceInfo.ops_status = 0;
+            list.append(QDBusVariant(QVariant::fromValue(deviceInfo)));
+        }
+        return count;
+    }
+
+    int GetFeatureList(int count, QList<QDBusVariant> &list)
+    {
+        for(int i = 0; i < count; i++) {
+            FeatureInfo featureInfo;
+            featureInfo.uid = 1000 + i / 10;
+            featureInfo.biotype = 0;
+            featureInfo.device_shortname = "device_0";
+            featureInfo.index = i % 10 + 1;
+            featureInfo.index_name = QString("feature%1").arg(i);
+            list.append(QDBusVariant(QVariant::fromValue(featureInfo)));
+        }
+        return count;
+    }
+
+    int Search(int count, QList<QDBusVariant> &list)
+    {
+        for(int i = 0; i < count; i++) {
+            SearchResult ret;
+            ret.uid = 1000 + i / 10;
+            ret.index = i % 10 + 1;
+            ret.indexName = QString("feature%1").arg(i);
+            list.append(QDBusVariant(QVariant::fromValue(ret)));
+        }
+        return count;
+    }
+};
+
+template <typename T>
+int decodeLegacy(const QDBusMessage &reply)
+{
+    QList<QDBusVariant> qlist = qdbus_cast<QList<QDBusVariant> >(reply.arguments().at(1));
+    QList<T *> result;
+    for(int i = 0; i < qlist.size(); i++) {
+        T *element = new T;
+        qlist[i].variant().value<QDBusArgument>() >> *element;
+        result.append(element);
+    }
+    int size = result.size();
+    qDeleteAll(result);
+    return size;
+}
+
+template <typename T>
+int decodeTyped(const QDBusMessage &reply, int count)
+{
+    return decodeVariantArray<T>(reply, 1, count).size();
+}
+
+template <typename T>
+void runBenchmark(QDBusConnection &connection, const char *method, int count)
+{
+    QDBusMessage call = QDBusMessage::createMethodCall(QString(), BENCH_PATH,
+                                                       BENCH_INTERFACE, method);
+    call << count;
+    QDBusMessage reply = connection.call(call, QDBus::Block, 600000);
+    if(reply.type() != QDBusMessage::ReplyMessage) {
+        qWarning() << method << count << reply.errorMessage();
+        return;
+    }
+
+    int rounds = qMax(3, 200000 / count);
+    QElapsedTimer timer;
+    qint64 legacy = 0, typed = 0;
+
+    for(int i = 0; i < rounds; i++) {
+        timer.start();
+        if(decodeLegacy<T>(reply) != count)
+            qWarning() << "legacy decode size mismatch";
+        legacy += timer.nsecsElapsed();
+
+        timer.start();
+        if(decodeTyped<T>(reply, count) != count)
+            qWarning() << "typed decode size mismatch";
+        typed += timer.nsecsElapsed();
+    }
+
+    printf("%-16s %8d  legacy %9.1f us  typed %9.1f us  (%6.1f / %6.1f ns per element)\n",
+           method, count,
+           legacy / rounds / 1000.0, typed / rounds / 1000.0,
+           double(legacy) / rounds / count, double(typed) / rounds / count);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    registerCustomTypes();
+
+    /* 服务端对象放在单独的线程中，主线程可以同步调用 */
+    QThread serverThread;
+    ListProvider provider;
+    provider.moveToThread(&serverThread);
+    serverThread.start();
+
+    QDBusServer server(QString("unix:tmpdir=%1").arg(QDir::tempPath()));
+    if(!server.isConnected()) {
+        qWarning() << "cannot start peer-to-peer server:" << server.lastError().message();
+        return EXIT_FAILURE;
+    }
+
+    bool registered = false;
+    QObject::connect(&server, &QDBusServer::newConnection,
+                     [&](const QDBusConnection &peer) {
+        QDBusConnection connection(peer);
+        registered = connection.registerObject(BENCH_PATH, &provider,
+                                               QDBusConnection::ExportAllSlots);
+    });
+
+    QDBusConnection client = QDBusConnection::connectToPeer(server.address(), "benchmark");
+    while(!registered && client.isConnected())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    if(!registered) {
+        qWarning() << "cannot connect to peer:" << client.lastError().message();
+        return EXIT_FAILURE;
+    }
+
+    for(int count : {1000, 10000, 100000}) {
+        runBenchmark<FeatureInfo>(client, "GetFeatureList", count);
+        runBenchmark<DeviceInfo>(client, "GetDrvList", count);
+        runBenchmark<SearchResult>(client, "Search", count);
+    }
+
+    QDBusConnection::disconnectFromPeer("benchmark");
+    serverThread.quit();
+    serverThread.wait();
+    return EXIT_SUCCESS;
+}
+
+#include "main.moc"